@@ -9,6 +9,11 @@
 #include <dolfinx/io/XDMFFile.h>
 #include "structures.h"
 #include "coupler_config.h"
+#include "redistribution.h"
+#include "coupling_schedule.h"
+#include "input_decks.h"
+#include "perf_model.h"
+#include "trace.h"
 #include "const_op.h"
 
 namespace po = boost::program_options;
@@ -168,7 +173,7 @@ MatNullSpace build_near_nullspace(const dolfinx::fem::FunctionSpace& V)
   return ns;
 }
 
-int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number, struct unit units[], struct locators relative_positions[])
+int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number, struct unit units[], struct input_decks *decks)
 {
   // Initialization and Filename definitions
   MPI_Comm fenics_comm = MPI_Comm_f2c(comm_int);
@@ -187,37 +192,21 @@ int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number,
   strcat(default_name, filename);
   FILE *fp = fopen(default_name, "w");
 
-  //set up the command line arguments for FENICSX
-  FILE *input = fopen("Fenics_input", "r");
+  //set up the command line arguments for FENICSX from Fenics_input, which rank 0 read at startup
   int max_bufsize = 200;
   int numinputs = 20;
-  char buff[max_bufsize];
   char **argv_fenics = (char **) malloc(numinputs*sizeof(char*));
   for(int i = 0; i < numinputs; i++){
     argv_fenics[i] = (char *) malloc(max_bufsize*sizeof(char));
   }
   int argc_fenics = 0; //first variable should be file name
-  if(input == NULL){
+  if(decks->fenics_input.empty()){
     fprintf(stderr, "Can't open input file Fenics_input\n");
     exit(1);
   }else{
-    while(fgets(buff, max_bufsize, input) != NULL){
-      buff[strcspn(buff, "\n")] = 0;
-      char temp[100];
-      strcpy(temp, buff);
-      char * tmp = strtok(temp, " \n");
-      if(tmp != NULL){
-        while(tmp != NULL){
-          if(strcmp(tmp, " ")){
-            argc_fenics++;
-            strcpy(argv_fenics[argc_fenics], tmp);
-          }
-          tmp = strtok(NULL, " \n");
-        }
-      }else{
-        argc_fenics++;
-        strcpy(argv_fenics[argc_fenics], buff);
-      }
+    for(int i = 0; i < (int) decks->fenics_input.size(); i++){
+      argc_fenics++;
+      strcpy(argv_fenics[argc_fenics], decks->fenics_input[i].c_str());
     }
   }
   argc_fenics++;
@@ -520,7 +509,7 @@ int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number,
     t_12th.stop();
 
     //Find own structure
-    int fenics_unit_num = relative_positions[world_rank].placelocator;
+    int fenics_unit_num = instance_number;
     int unit_count = 0;
     int work_count = 1; //since units start from 1
     bool found = false;
@@ -548,9 +537,6 @@ int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number,
     if(internal_rank==0)
       fprintf(fp, "boudary size %f\n", nodes_size);
 
-    double *p_variables_data = (double*) malloc(nodes_size * NVAR * sizeof(double));
-    double *p_variables_recv = (double*) malloc(nodes_size * NVAR * sizeof(double));
-
     int total_coupler_unit_count = units[unit_count].coupler_ranks.size();
     int ranks_per_coupler;
     if (internal_rank == 0){
@@ -562,6 +548,46 @@ int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number,
         }
       }
     }
+    std::vector<struct redistribution> exchanges(total_coupler_unit_count);//exchanges with the coupler ranks, one per coupler unit
+    for(int z = 0; z < total_coupler_unit_count; z++){
+      int coupler_rank = units[unit_count].coupler_ranks[z][0];
+      int coupler_unit = units[unit_count].coupler_units[z];
+      int exchange_vars = (units[coupler_unit].coupling_type == 'S') ? 5 : 1;
+      if(mxn_redistribution){
+        //the coupler root replies with both interface sizes, which every rank needs to find the coupler ranks its piece goes to
+        double interface_sizes[2];
+        if(internal_rank == 0){
+          MPI_Recv(interface_sizes, 2, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+        MPI_Bcast(interface_sizes, 2, MPI_DOUBLE, 0, fenics_comm);
+        bool is_left = (units[coupler_unit].mgcfd_ranks[0][0] == units[unit_count].mgcfd_ranks[0][0]);
+        redistribution_unit_schedule(&exchanges[z], units[unit_count].coupler_ranks[z], interface_sizes[0], interface_sizes[1], is_left, internal_rank, internal_size, exchange_vars);
+      }else if(internal_rank == 0){
+        redistribution_root_schedule(&exchanges[z], coupler_rank, nodes_size, -1, 0, exchange_vars);
+      }
+    }
+    double *p_variables_data;
+    double *p_variables_recv;
+    //with a single coupler on the same node the root writes the interface straight into shared memory the coupler reads
+    if(internal_rank == 0 && shared_memory_transport && !mxn_redistribution && coupling_staleness == 0 && total_coupler_unit_count == 1
+        && redistribution_share(&exchanges[0], 0, true, nodes_size * NVAR)){
+      p_variables_data = exchanges[0].pieces[0].shared_send;
+      p_variables_recv = exchanges[0].pieces[0].shared_recv;
+    }else{
+      p_variables_data = (double*) malloc(nodes_size * NVAR * sizeof(double));
+      p_variables_recv = (double*) malloc(nodes_size * NVAR * sizeof(double));
+    }
+    //otherwise it can expose the interface for the coupler to get and put when ready
+    if(internal_rank == 0 && one_sided_transport && !mxn_redistribution && total_coupler_unit_count == 1 && exchanges[0].pieces[0].shared_send == NULL){
+      redistribution_expose(&exchanges[0], 0, true, nodes_size * NVAR);
+    }
+    std::vector<struct coupling_schedule> schedules(total_coupler_unit_count);
+    for(int z = 0; z < total_coupler_unit_count; z++){
+      double *landing = coupling_schedule_init(&schedules[z], coupling_staleness, p_variables_recv, nodes_size * NVAR);
+      char coupling_type = units[units[unit_count].coupler_units[z]].coupling_type;
+      redistribution_compress(&exchanges[z], codec_select(coupling_type, sliding_codec, overset_codec, cht_codec), codec_error_bound);
+      redistribution_bind(&exchanges[z], p_variables_data, p_variables_data, landing, landing);
+    }
 
 
     if(internal_rank == 0)
@@ -570,6 +596,9 @@ int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number,
     //Calculate number of cycles
     int fenics_cycles = coupler_cycles*fenics_conversion_factor;
     common::Timer t_13th("05 Compute");
+    double solve_seconds = 0.0;//the root's time in the solvers, for the calibration record
+    struct trace timeline;
+    trace_init(&timeline, trace_timeline, "FEniCS X " + std::to_string(instance_number), unit_count, internal_rank);
 
     for(int i = 0; i < fenics_cycles; i++){
       t->value[0] = t->value[0] + dt->value[0];
@@ -579,6 +608,8 @@ int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number,
       }
 
       common::Timer t_15th("07 pure Compute");
+      double solve_start = MPI_Wtime();
+      double trace_solve = trace_now();
       // Solving for thermal
       nlth_solver.setF(problem_th.F(), problem_th.vector());
       nlth_solver.setJ(problem_th.J(), problem_th.matrix());
@@ -603,66 +634,57 @@ int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number,
         xdmf_file_st.write_function(*u_st, t->value[0]);
       }
       t_15th.stop();
+      solve_seconds += MPI_Wtime() - solve_start;
+      int coupling_cycle = i / fenics_conversion_factor;
+      trace_record(&timeline, TRACE_SOLVE, trace_solve, coupling_cycle);
       //Send data
-      if((i % fenics_conversion_factor == 0) || (hide_search == true && ((i % fenics_conversion_factor) == fenics_conversion_factor - 1))){
-        VecScatterBegin(scat, _u_th.vec(), send, INSERT_VALUES, SCATTER_FORWARD);
-        VecScatterEnd(scat, _u_th.vec(), send, INSERT_VALUES, SCATTER_FORWARD);
-        if(internal_rank == 0){
-          PetscScalar *send_array;
-          VecGetArray(send, &send_array);
-          for(int k = 0; k < NVAR; k++){
-            for(int j = 0; j < nodes_size; j++){
-              p_variables_data[(int) (nodes_size*k)+j] = send_array[j];
-            }
-          }
-          VecRestoreArray(send, &send_array);
-          printf("FEniCS X cycle %d comms starting\n", i+1);
+      if(i % fenics_conversion_factor == 0){
+        double trace_start = trace_now();
+        if(internal_rank == 0 || mxn_redistribution){
           for(int j = 0; j < total_coupler_unit_count; j++){
-            int coupler_rank = units[unit_count].coupler_ranks[j][0];
-            int coupler_position = relative_positions[coupler_rank].placelocator;
-            found = false;
-            int unit_count_2 = 0;
-            int coupler_unit_count = 1;
-            while(!found){//this is used to find out the unit index of the coupler unit
-              if(units[unit_count_2].type == 'C' && coupler_unit_count == coupler_position){
-                found=true;
-              }else{
-                if(units[unit_count_2].type == 'C'){
-                  coupler_unit_count++;
-                }
-                unit_count_2++;
+            coupling_schedule_ready(&schedules[j], &exchanges[j]);
+          }
+        }
+        if(mxn_redistribution){
+          //each rank sends its own piece of the interface; it is stand-in data, the temperature values this rank owns repeated, or zeros on a rank that owns none
+          std::size_t owned = uth_span.size();
+          for(int k = 0; k < nodes_size * NVAR; k++){
+            p_variables_data[k] = (owned > 0) ? uth_span[k % owned] : 0.0;
+          }
+        }else{
+          VecScatterBegin(scat, _u_th.vec(), send, INSERT_VALUES, SCATTER_FORWARD);
+          VecScatterEnd(scat, _u_th.vec(), send, INSERT_VALUES, SCATTER_FORWARD);
+        }
+        if(internal_rank == 0 || mxn_redistribution){
+          if(!mxn_redistribution){
+            PetscScalar *send_array;
+            VecGetArray(send, &send_array);
+            for(int k = 0; k < NVAR; k++){
+              for(int j = 0; j < nodes_size; j++){
+                p_variables_data[(int) (nodes_size*k)+j] = send_array[j];
               }
             }
-            int coupler_vars = 0;
-            if(units[unit_count_2].coupling_type == 'S'){
-              coupler_vars = 5;
-            }else if(units[unit_count_2].coupling_type == 'C'){
-              coupler_vars = 1;
-            }
-			common::Timer t_15th("06 waiting");
-            if(hide_search == true){
-              if((i % (search_freq*fenics_conversion_factor)) == 0){
-                MPI_Send(p_variables_data, nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD);
-				t_15th.stop();
-              }else if((i % fenics_conversion_factor) == fenics_conversion_factor - 1){
-				common::Timer t_14th("06 Coupling");
-                MPI_Recv(p_variables_recv, nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-				t_14th.stop();
-              }else{
-                MPI_Send(p_variables_data, nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD);
-				t_15th.stop();
-				common::Timer t_14th("06 Coupling");
-                MPI_Recv(p_variables_recv, nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                t_14th.stop();
-			  }
-            }else{
-              MPI_Send(p_variables_data, nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD);
-			  t_15th.stop();
-			  common::Timer t_14th("06 Coupling");
-              MPI_Recv(p_variables_recv, nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-              t_14th.stop();
-            }
+            VecRestoreArray(send, &send_array);
+          }
+          if(internal_rank == 0){
+            printf("FEniCS X cycle %d comms starting\n", i+1);
           }
+          trace_record(&timeline, TRACE_PACK, trace_start, coupling_cycle);
+          //post this cycle's interface and only wait for replies once the boundary would be too stale
+          for(int j = 0; j < total_coupler_unit_count; j++){
+            common::Timer t_15th("06 waiting");
+            trace_start = trace_now();
+            coupling_schedule_post(&schedules[j], &exchanges[j]);
+            trace_record(&timeline, TRACE_SEND, trace_start, coupling_cycle);
+            t_15th.stop();
+            common::Timer t_14th("06 Coupling");
+            trace_start = trace_now();
+            coupling_schedule_sync(&schedules[j], &exchanges[j]);
+            trace_record(&timeline, TRACE_WAIT, trace_start, coupling_cycle);
+            t_14th.stop();
+          }
+        }else{
+          trace_record(&timeline, TRACE_PACK, trace_start, coupling_cycle);
         }
       }
       if(internal_rank == 0){
@@ -671,6 +693,19 @@ int main_dolfinx(int argc, char *argv[], MPI_Fint comm_int, int instance_number,
       }
     }
     t_13th.stop();
+    for(int z = 0; z < total_coupler_unit_count; z++){
+      if(internal_rank == 0 || mxn_redistribution){
+        coupling_schedule_finish(&schedules[z], &exchanges[z]);
+      }
+      if(internal_rank == 0){
+        coupling_schedule_print(&schedules[z], "FEniCS X", instance_number);
+      }
+      if(record_calibration && internal_rank == 0 && z == 0 && schedules[z].posted > 0){
+        perf_model_record("unit", 'F', unit_count, internal_size, size_u, solve_seconds / schedules[z].posted);
+      }
+      redistribution_free(&exchanges[z]);
+    }
+    trace_write(&timeline, fenics_comm);
 
     if(strut_flag == 1){
       xdmf_file_th.close();
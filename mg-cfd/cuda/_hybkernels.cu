@@ -12,14 +12,19 @@
 #define op_par_loop_copy_double_kernel op_par_loop_copy_double_kernel_gpu
 #define op_par_loop_calculate_dt_kernel op_par_loop_calculate_dt_kernel_gpu
 #define op_par_loop_get_min_dt_kernel op_par_loop_get_min_dt_kernel_gpu
+#define op_par_loop_copy_calculate_min_dt_kernel op_par_loop_copy_calculate_min_dt_kernel_gpu
 #define op_par_loop_compute_step_factor_kernel op_par_loop_compute_step_factor_kernel_gpu
 #define op_par_loop_compute_flux_edge_kernel op_par_loop_compute_flux_edge_kernel_gpu
+#define op_par_loop_compute_node_primitives_kernel op_par_loop_compute_node_primitives_kernel_gpu
+#define op_par_loop_compute_flux_edge_primitives_kernel op_par_loop_compute_flux_edge_primitives_kernel_gpu
 #define op_par_loop_compute_bnd_node_flux_kernel op_par_loop_compute_bnd_node_flux_kernel_gpu
 #define op_par_loop_time_step_kernel op_par_loop_time_step_kernel_gpu
+#define op_par_loop_time_step_min_dt_kernel op_par_loop_time_step_min_dt_kernel_gpu
 #define op_par_loop_indirect_rw_kernel op_par_loop_indirect_rw_kernel_gpu
 #define op_par_loop_residual_kernel op_par_loop_residual_kernel_gpu
 #define op_par_loop_calc_rms_kernel op_par_loop_calc_rms_kernel_gpu
 #define op_par_loop_count_bad_vals op_par_loop_count_bad_vals_gpu
+#define op_par_loop_residual_rms_kernel op_par_loop_residual_rms_kernel_gpu
 #define op_par_loop_up_pre_kernel op_par_loop_up_pre_kernel_gpu
 #define op_par_loop_up_kernel op_par_loop_up_kernel_gpu
 #define op_par_loop_up_post_kernel op_par_loop_up_post_kernel_gpu
@@ -38,14 +43,19 @@
 #undef op_par_loop_copy_double_kernel
 #undef op_par_loop_calculate_dt_kernel
 #undef op_par_loop_get_min_dt_kernel
+#undef op_par_loop_copy_calculate_min_dt_kernel
 #undef op_par_loop_compute_step_factor_kernel
 #undef op_par_loop_compute_flux_edge_kernel
+#undef op_par_loop_compute_node_primitives_kernel
+#undef op_par_loop_compute_flux_edge_primitives_kernel
 #undef op_par_loop_compute_bnd_node_flux_kernel
 #undef op_par_loop_time_step_kernel
+#undef op_par_loop_time_step_min_dt_kernel
 #undef op_par_loop_indirect_rw_kernel
 #undef op_par_loop_residual_kernel
 #undef op_par_loop_calc_rms_kernel
 #undef op_par_loop_count_bad_vals
+#undef op_par_loop_residual_rms_kernel
 #undef op_par_loop_up_pre_kernel
 #undef op_par_loop_up_kernel
 #undef op_par_loop_up_post_kernel
@@ -64,14 +74,19 @@
 #define op_par_loop_copy_double_kernel op_par_loop_copy_double_kernel_cpu
 #define op_par_loop_calculate_dt_kernel op_par_loop_calculate_dt_kernel_cpu
 #define op_par_loop_get_min_dt_kernel op_par_loop_get_min_dt_kernel_cpu
+#define op_par_loop_copy_calculate_min_dt_kernel op_par_loop_copy_calculate_min_dt_kernel_cpu
 #define op_par_loop_compute_step_factor_kernel op_par_loop_compute_step_factor_kernel_cpu
 #define op_par_loop_compute_flux_edge_kernel op_par_loop_compute_flux_edge_kernel_cpu
+#define op_par_loop_compute_node_primitives_kernel op_par_loop_compute_node_primitives_kernel_cpu
+#define op_par_loop_compute_flux_edge_primitives_kernel op_par_loop_compute_flux_edge_primitives_kernel_cpu
 #define op_par_loop_compute_bnd_node_flux_kernel op_par_loop_compute_bnd_node_flux_kernel_cpu
 #define op_par_loop_time_step_kernel op_par_loop_time_step_kernel_cpu
+#define op_par_loop_time_step_min_dt_kernel op_par_loop_time_step_min_dt_kernel_cpu
 #define op_par_loop_indirect_rw_kernel op_par_loop_indirect_rw_kernel_cpu
 #define op_par_loop_residual_kernel op_par_loop_residual_kernel_cpu
 #define op_par_loop_calc_rms_kernel op_par_loop_calc_rms_kernel_cpu
 #define op_par_loop_count_bad_vals op_par_loop_count_bad_vals_cpu
+#define op_par_loop_residual_rms_kernel op_par_loop_residual_rms_kernel_cpu
 #define op_par_loop_up_pre_kernel op_par_loop_up_pre_kernel_cpu
 #define op_par_loop_up_kernel op_par_loop_up_kernel_cpu
 #define op_par_loop_up_post_kernel op_par_loop_up_post_kernel_cpu
@@ -90,14 +105,19 @@
 #undef op_par_loop_copy_double_kernel
 #undef op_par_loop_calculate_dt_kernel
 #undef op_par_loop_get_min_dt_kernel
+#undef op_par_loop_copy_calculate_min_dt_kernel
 #undef op_par_loop_compute_step_factor_kernel
 #undef op_par_loop_compute_flux_edge_kernel
+#undef op_par_loop_compute_node_primitives_kernel
+#undef op_par_loop_compute_flux_edge_primitives_kernel
 #undef op_par_loop_compute_bnd_node_flux_kernel
 #undef op_par_loop_time_step_kernel
+#undef op_par_loop_time_step_min_dt_kernel
 #undef op_par_loop_indirect_rw_kernel
 #undef op_par_loop_residual_kernel
 #undef op_par_loop_calc_rms_kernel
 #undef op_par_loop_count_bad_vals
+#undef op_par_loop_residual_rms_kernel
 #undef op_par_loop_up_pre_kernel
 #undef op_par_loop_up_kernel
 #undef op_par_loop_up_post_kernel
@@ -382,6 +402,52 @@ void op_par_loop_get_min_dt_kernel(char const *name, op_set set,
   }
 #endif //OP_HYBRID_GPU
 
+void op_par_loop_copy_calculate_min_dt_kernel_gpu(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3);
+
+//GPU host stub function
+#if OP_HYBRID_GPU
+void op_par_loop_copy_calculate_min_dt_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3){
+
+  if (OP_hybrid_gpu) {
+    op_par_loop_copy_calculate_min_dt_kernel_gpu(name, set,
+      arg0,
+      arg1,
+      arg2,
+      arg3);
+
+    }else{
+    op_par_loop_copy_calculate_min_dt_kernel_cpu(name, set,
+      arg0,
+      arg1,
+      arg2,
+      arg3);
+
+  }
+}
+#else
+void op_par_loop_copy_calculate_min_dt_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3){
+
+  op_par_loop_copy_calculate_min_dt_kernel_gpu(name, set,
+    arg0,
+    arg1,
+    arg2,
+    arg3);
+
+  }
+#endif //OP_HYBRID_GPU
+
 void op_par_loop_compute_step_factor_kernel_gpu(char const *name, op_set set,
   op_arg arg0,
   op_arg arg1,
@@ -480,6 +546,92 @@ void op_par_loop_compute_flux_edge_kernel(char const *name, op_set set,
   }
 #endif //OP_HYBRID_GPU
 
+void op_par_loop_compute_node_primitives_kernel_gpu(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1);
+
+//GPU host stub function
+#if OP_HYBRID_GPU
+void op_par_loop_compute_node_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1){
+
+  if (OP_hybrid_gpu) {
+    op_par_loop_compute_node_primitives_kernel_gpu(name, set,
+      arg0,
+      arg1);
+
+    }else{
+    op_par_loop_compute_node_primitives_kernel_cpu(name, set,
+      arg0,
+      arg1);
+
+  }
+}
+#else
+void op_par_loop_compute_node_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1){
+
+  op_par_loop_compute_node_primitives_kernel_gpu(name, set,
+    arg0,
+    arg1);
+
+  }
+#endif //OP_HYBRID_GPU
+
+void op_par_loop_compute_flux_edge_primitives_kernel_gpu(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4);
+
+//GPU host stub function
+#if OP_HYBRID_GPU
+void op_par_loop_compute_flux_edge_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  if (OP_hybrid_gpu) {
+    op_par_loop_compute_flux_edge_primitives_kernel_gpu(name, set,
+      arg0,
+      arg1,
+      arg2,
+      arg3,
+      arg4);
+
+    }else{
+    op_par_loop_compute_flux_edge_primitives_kernel_cpu(name, set,
+      arg0,
+      arg1,
+      arg2,
+      arg3,
+      arg4);
+
+  }
+}
+#else
+void op_par_loop_compute_flux_edge_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  op_par_loop_compute_flux_edge_primitives_kernel_gpu(name, set,
+    arg0,
+    arg1,
+    arg2,
+    arg3,
+    arg4);
+
+  }
+#endif //OP_HYBRID_GPU
+
 void op_par_loop_compute_bnd_node_flux_kernel_gpu(char const *name, op_set set,
   op_arg arg0,
   op_arg arg1,
@@ -578,6 +730,64 @@ void op_par_loop_time_step_kernel(char const *name, op_set set,
   }
 #endif //OP_HYBRID_GPU
 
+void op_par_loop_time_step_min_dt_kernel_gpu(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4,
+  op_arg arg5);
+
+//GPU host stub function
+#if OP_HYBRID_GPU
+void op_par_loop_time_step_min_dt_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4,
+  op_arg arg5){
+
+  if (OP_hybrid_gpu) {
+    op_par_loop_time_step_min_dt_kernel_gpu(name, set,
+      arg0,
+      arg1,
+      arg2,
+      arg3,
+      arg4,
+      arg5);
+
+    }else{
+    op_par_loop_time_step_min_dt_kernel_cpu(name, set,
+      arg0,
+      arg1,
+      arg2,
+      arg3,
+      arg4,
+      arg5);
+
+  }
+}
+#else
+void op_par_loop_time_step_min_dt_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4,
+  op_arg arg5){
+
+  op_par_loop_time_step_min_dt_kernel_gpu(name, set,
+    arg0,
+    arg1,
+    arg2,
+    arg3,
+    arg4,
+    arg5);
+
+  }
+#endif //OP_HYBRID_GPU
+
 void op_par_loop_indirect_rw_kernel_gpu(char const *name, op_set set,
   op_arg arg0,
   op_arg arg1,
@@ -738,6 +948,58 @@ void op_par_loop_count_bad_vals(char const *name, op_set set,
   }
 #endif //OP_HYBRID_GPU
 
+void op_par_loop_residual_rms_kernel_gpu(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4);
+
+//GPU host stub function
+#if OP_HYBRID_GPU
+void op_par_loop_residual_rms_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  if (OP_hybrid_gpu) {
+    op_par_loop_residual_rms_kernel_gpu(name, set,
+      arg0,
+      arg1,
+      arg2,
+      arg3,
+      arg4);
+
+    }else{
+    op_par_loop_residual_rms_kernel_cpu(name, set,
+      arg0,
+      arg1,
+      arg2,
+      arg3,
+      arg4);
+
+  }
+}
+#else
+void op_par_loop_residual_rms_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  op_par_loop_residual_rms_kernel_gpu(name, set,
+    arg0,
+    arg1,
+    arg2,
+    arg3,
+    arg4);
+
+  }
+#endif //OP_HYBRID_GPU
+
 void op_par_loop_up_pre_kernel_gpu(char const *name, op_set set,
   op_arg arg0,
   op_arg arg1);
@@ -80,14 +80,19 @@ int size, char *dat, char const *name){
 #include "copy_double_kernel_kernel.cu"
 #include "calculate_dt_kernel_kernel.cu"
 #include "get_min_dt_kernel_kernel.cu"
+#include "copy_calculate_min_dt_kernel_kernel.cu"
 #include "compute_step_factor_kernel_kernel.cu"
 #include "compute_flux_edge_kernel_kernel.cu"
+#include "compute_node_primitives_kernel_kernel.cu"
+#include "compute_flux_edge_primitives_kernel_kernel.cu"
 #include "compute_bnd_node_flux_kernel_kernel.cu"
 #include "time_step_kernel_kernel.cu"
+#include "time_step_min_dt_kernel_kernel.cu"
 #include "indirect_rw_kernel_kernel.cu"
 #include "residual_kernel_kernel.cu"
 #include "calc_rms_kernel_kernel.cu"
 #include "count_bad_vals_kernel.cu"
+#include "residual_rms_kernel_kernel.cu"
 #include "up_pre_kernel_kernel.cu"
 #include "up_kernel_kernel.cu"
 #include "up_post_kernel_kernel.cu"
@@ -0,0 +1,219 @@
+//
+// auto-generated by op2.py
+//
+
+#include <math.h>
+#include "inlined_funcs.h"
+#include "global.h"
+#include "config.h"
+
+//user function
+__device__ void compute_flux_edge_primitives_kernel_gpu( 
+    const double *primitives_a,
+    const double *primitives_b,
+    const double *edge_weight,
+    double *fluxes_a,
+    double *fluxes_b) {
+  double ewt = std::sqrt(edge_weight[0]*edge_weight[0] +
+                         edge_weight[1]*edge_weight[1] +
+                         edge_weight[2]*edge_weight[2]);
+
+  double p_a = primitives_a[PRIM_DENSITY],
+         p_b = primitives_b[PRIM_DENSITY];
+  double pe_a = primitives_a[PRIM_DENSITY_ENERGY],
+         pe_b = primitives_b[PRIM_DENSITY_ENERGY];
+  double3 momentum_a, momentum_b;
+  momentum_a.x = primitives_a[PRIM_MOMENTUM+0];
+  momentum_a.y = primitives_a[PRIM_MOMENTUM+1];
+  momentum_a.z = primitives_a[PRIM_MOMENTUM+2];
+  momentum_b.x = primitives_b[PRIM_MOMENTUM+0];
+  momentum_b.y = primitives_b[PRIM_MOMENTUM+1];
+  momentum_b.z = primitives_b[PRIM_MOMENTUM+2];
+
+  double speed_a = primitives_a[PRIM_SPEED],
+         speed_b = primitives_b[PRIM_SPEED];
+  double speed_of_sound_a = primitives_a[PRIM_SPEED_OF_SOUND],
+         speed_of_sound_b = primitives_b[PRIM_SPEED_OF_SOUND];
+
+  double factor_a = -ewt*smoothing_coefficient_cuda*0.5
+                    *(speed_a + speed_b
+                    + speed_of_sound_a + speed_of_sound_b);
+
+  double factor_b = -ewt*smoothing_coefficient_cuda*0.5
+                    *(speed_b + speed_a
+                    + speed_of_sound_b + speed_of_sound_a);
+
+  double factor_x = -0.5*edge_weight[0], factor_y = -0.5*edge_weight[1], factor_z = -0.5*edge_weight[2];
+
+  fluxes_a[VAR_DENSITY] +=
+      factor_a*(p_a - p_b)
+    + factor_x*(momentum_a.x + momentum_b.x)
+    + factor_y*(momentum_a.y + momentum_b.y)
+    + factor_z*(momentum_a.z + momentum_b.z);
+
+  fluxes_a[VAR_DENSITY_ENERGY] +=
+      factor_a*(pe_a - pe_b)
+    + factor_x*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+0] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+0])
+    + factor_y*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+1] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+1])
+    + factor_z*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+2] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+2]);
+
+  fluxes_a[VAR_MOMENTUM + 0] +=
+      factor_a*(momentum_a.x - momentum_b.x)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_X+0] + primitives_b[PRIM_FLUX_MOMENTUM_X+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_X+1] + primitives_b[PRIM_FLUX_MOMENTUM_X+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_X+2] + primitives_b[PRIM_FLUX_MOMENTUM_X+2]);
+
+  fluxes_a[VAR_MOMENTUM + 1] +=
+      factor_a*(momentum_a.y - momentum_b.y)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Y+0] + primitives_b[PRIM_FLUX_MOMENTUM_Y+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Y+1] + primitives_b[PRIM_FLUX_MOMENTUM_Y+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Y+2] + primitives_b[PRIM_FLUX_MOMENTUM_Y+2]);
+
+  fluxes_a[VAR_MOMENTUM + 2] +=
+      factor_a*(momentum_a.z - momentum_b.z)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Z+0] + primitives_b[PRIM_FLUX_MOMENTUM_Z+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Z+1] + primitives_b[PRIM_FLUX_MOMENTUM_Z+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Z+2] + primitives_b[PRIM_FLUX_MOMENTUM_Z+2]);
+
+  fluxes_b[VAR_DENSITY] +=
+      factor_b*(p_b - p_a)
+    - factor_x*(momentum_a.x + momentum_b.x)
+    - factor_y*(momentum_a.y + momentum_b.y)
+    - factor_z*(momentum_a.z + momentum_b.z);
+
+  fluxes_b[VAR_DENSITY_ENERGY] +=
+      factor_b*(pe_b - pe_a)
+    - factor_x*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+0] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+0])
+    - factor_y*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+1] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+1])
+    - factor_z*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+2] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+2]);
+
+  fluxes_b[VAR_MOMENTUM + 0] +=
+      factor_b*(momentum_b.x - momentum_a.x)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_X+0] + primitives_b[PRIM_FLUX_MOMENTUM_X+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_X+1] + primitives_b[PRIM_FLUX_MOMENTUM_X+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_X+2] + primitives_b[PRIM_FLUX_MOMENTUM_X+2]);
+
+  fluxes_b[VAR_MOMENTUM + 1] +=
+      factor_b*(momentum_b.y - momentum_a.y)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Y+0] + primitives_b[PRIM_FLUX_MOMENTUM_Y+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Y+1] + primitives_b[PRIM_FLUX_MOMENTUM_Y+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Y+2] + primitives_b[PRIM_FLUX_MOMENTUM_Y+2]);
+
+  fluxes_b[VAR_MOMENTUM + 2] +=
+      factor_b*(momentum_b.z - momentum_a.z)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Z+0] + primitives_b[PRIM_FLUX_MOMENTUM_Z+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Z+1] + primitives_b[PRIM_FLUX_MOMENTUM_Z+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Z+2] + primitives_b[PRIM_FLUX_MOMENTUM_Z+2]);
+
+}
+
+// CUDA kernel function
+__global__ void op_cuda_compute_flux_edge_primitives_kernel(
+  const double *__restrict ind_arg0,
+  double *__restrict ind_arg1,
+  const int *__restrict opDat0Map,
+  const double *__restrict arg2,
+  int start,
+  int end,
+  int   set_size) {
+  int tid = threadIdx.x + blockIdx.x * blockDim.x;
+  if (tid + start < end) {
+    int n = tid + start;
+    //initialise local variables
+    double arg3_l[5];
+    for ( int d=0; d<5; d++ ){
+      arg3_l[d] = ZERO_double;
+    }
+    double arg4_l[5];
+    for ( int d=0; d<5; d++ ){
+      arg4_l[d] = ZERO_double;
+    }
+    int map0idx;
+    int map1idx;
+    map0idx = opDat0Map[n + set_size * 0];
+    map1idx = opDat0Map[n + set_size * 1];
+
+    //user-supplied kernel call
+    compute_flux_edge_primitives_kernel_gpu(ind_arg0+map0idx*19,
+                             ind_arg0+map1idx*19,
+                             arg2+n*3,
+                             arg3_l,
+                             arg4_l);
+    atomicAdd(&ind_arg1[0+map0idx*5],arg3_l[0]);
+    atomicAdd(&ind_arg1[1+map0idx*5],arg3_l[1]);
+    atomicAdd(&ind_arg1[2+map0idx*5],arg3_l[2]);
+    atomicAdd(&ind_arg1[3+map0idx*5],arg3_l[3]);
+    atomicAdd(&ind_arg1[4+map0idx*5],arg3_l[4]);
+    atomicAdd(&ind_arg1[0+map1idx*5],arg4_l[0]);
+    atomicAdd(&ind_arg1[1+map1idx*5],arg4_l[1]);
+    atomicAdd(&ind_arg1[2+map1idx*5],arg4_l[2]);
+    atomicAdd(&ind_arg1[3+map1idx*5],arg4_l[3]);
+    atomicAdd(&ind_arg1[4+map1idx*5],arg4_l[4]);
+  }
+}
+
+
+//host stub function
+void op_par_loop_compute_flux_edge_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  int nargs = 5;
+  op_arg args[5];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+  args[4] = arg4;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(26);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[26].name      = name;
+  OP_kernels[26].count    += 1;
+
+
+  int    ninds   = 2;
+  int    inds[5] = {0,0,-1,1,1};
+
+  if (OP_diags>2) {
+    printf(" kernel routine with indirection: compute_flux_edge_primitives_kernel\n");
+  }
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+  if (set_size > 0) {
+
+    //set CUDA execution parameters
+    #ifdef OP_BLOCK_SIZE_26
+      int nthread = OP_BLOCK_SIZE_26;
+    #else
+      int nthread = OP_block_size;
+    #endif
+
+    for ( int round=0; round<2; round++ ){
+      if (round==1) {
+        op_mpi_wait_all_cuda(nargs, args);
+      }
+      int start = round==0 ? 0 : set->core_size;
+      int end = round==0 ? set->core_size : set->size + set->exec_size;
+      if (end-start>0) {
+        int nblocks = (end-start-1)/nthread+1;
+        op_cuda_compute_flux_edge_primitives_kernel<<<nblocks,nthread>>>(
+        (double *)arg0.data_d,
+        (double *)arg3.data_d,
+        arg0.map_data_d,
+        (double*)arg2.data_d,
+        start,end,set->size+set->exec_size);
+      }
+    }
+  }
+  op_mpi_set_dirtybit_cuda(nargs, args);
+  cutilSafeCall(cudaDeviceSynchronize());
+  //update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[26].time     += wall_t2 - wall_t1;
+}
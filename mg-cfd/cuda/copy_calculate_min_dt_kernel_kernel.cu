@@ -0,0 +1,157 @@
+//
+// auto-generated by op2.py
+//
+
+#include <math.h>
+#include <cmath>
+#include "const.h"
+#include "inlined_funcs.h"
+
+//user function
+__device__ void copy_calculate_min_dt_kernel_gpu( 
+    const double* variable,
+    const double* volume,
+    double* old_variable,
+    double* min_dt) {
+    double density = variable[VAR_DENSITY];
+
+    double3 momentum;
+    momentum.x = variable[VAR_MOMENTUM+0];
+    momentum.y = variable[VAR_MOMENTUM+1];
+    momentum.z = variable[VAR_MOMENTUM+2];
+
+    double density_energy = variable[VAR_DENSITY_ENERGY];
+
+    old_variable[VAR_DENSITY]        = density;
+    old_variable[VAR_MOMENTUM+0]     = momentum.x;
+    old_variable[VAR_MOMENTUM+1]     = momentum.y;
+    old_variable[VAR_MOMENTUM+2]     = momentum.z;
+    old_variable[VAR_DENSITY_ENERGY] = density_energy;
+
+    double3 velocity; compute_velocity(density, momentum, velocity);
+    double speed_sqd      = compute_speed_sqd(velocity);
+    double pressure       = compute_pressure(density, density_energy, speed_sqd);
+    double speed_of_sound = compute_speed_of_sound(density, pressure);
+
+    double dt = double(0.5) * (cbrt(*volume) / (sqrt(speed_sqd) + speed_of_sound));
+    if (dt < (*min_dt)) {
+        *min_dt = dt;
+    }
+
+}
+
+// CUDA kernel function
+__global__ void op_cuda_copy_calculate_min_dt_kernel(
+  const double *__restrict arg0,
+  const double *__restrict arg1,
+  double *arg2,
+  double *arg3,
+  int   set_size ) {
+
+  double arg3_l[1];
+  for ( int d=0; d<1; d++ ){
+    arg3_l[d]=arg3[d+blockIdx.x*1];
+  }
+
+  //process set elements
+  for ( int n=threadIdx.x+blockIdx.x*blockDim.x; n<set_size; n+=blockDim.x*gridDim.x ){
+
+    //user-supplied kernel call
+    copy_calculate_min_dt_kernel_gpu(arg0+n*5,
+                                 arg1+n*1,
+                                 arg2+n*5,
+                                 arg3_l);
+  }
+
+  //global reductions
+
+  for ( int d=0; d<1; d++ ){
+    op_reduction<OP_MIN>(&arg3[d+blockIdx.x*1],arg3_l[d]);
+  }
+}
+
+
+//host stub function
+void op_par_loop_copy_calculate_min_dt_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3){
+
+  double*arg3h = (double *)arg3.data;
+  int nargs = 4;
+  op_arg args[4];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(27);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[27].name      = name;
+  OP_kernels[27].count    += 1;
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  copy_calculate_min_dt_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+  if (set_size > 0) {
+
+    //set CUDA execution parameters
+    #ifdef OP_BLOCK_SIZE_27
+      int nthread = OP_BLOCK_SIZE_27;
+    #else
+      int nthread = OP_block_size;
+    #endif
+
+    int nblocks = 200;
+
+    //transfer global reduction data to GPU
+    int maxblocks = nblocks;
+    int reduct_bytes = 0;
+    int reduct_size  = 0;
+    reduct_bytes += ROUND_UP(maxblocks*1*sizeof(double));
+    reduct_size   = MAX(reduct_size,sizeof(double));
+    reallocReductArrays(reduct_bytes);
+    reduct_bytes = 0;
+    arg3.data   = OP_reduct_h + reduct_bytes;
+    arg3.data_d = OP_reduct_d + reduct_bytes;
+    for ( int b=0; b<maxblocks; b++ ){
+      for ( int d=0; d<1; d++ ){
+        ((double *)arg3.data)[d+b*1] = arg3h[d];
+      }
+    }
+    reduct_bytes += ROUND_UP(maxblocks*1*sizeof(double));
+    mvReductArraysToDevice(reduct_bytes);
+
+    int nshared = reduct_size*nthread;
+    op_cuda_copy_calculate_min_dt_kernel<<<nblocks,nthread,nshared>>>(
+      (double *) arg0.data_d,
+      (double *) arg1.data_d,
+      (double *) arg2.data_d,
+      (double *) arg3.data_d,
+      set->size );
+    //transfer global reduction data back to CPU
+    mvReductArraysToHost(reduct_bytes);
+    for ( int b=0; b<maxblocks; b++ ){
+      for ( int d=0; d<1; d++ ){
+        arg3h[d] = MIN(arg3h[d],((double *)arg3.data)[d+b*1]);
+      }
+    }
+    arg3.data = (char *)arg3h;
+    op_mpi_reduce(&arg3,arg3h);
+  }
+  op_mpi_set_dirtybit_cuda(nargs, args);
+  cutilSafeCall(cudaDeviceSynchronize());
+  //update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[27].time     += wall_t2 - wall_t1;
+  OP_kernels[27].transfer += (float)set->size * arg0.size;
+  OP_kernels[27].transfer += (float)set->size * arg1.size;
+  OP_kernels[27].transfer += (float)set->size * arg2.size * 2.0f;
+}
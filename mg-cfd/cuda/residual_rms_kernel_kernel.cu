@@ -0,0 +1,174 @@
+//
+// auto-generated by op2.py
+//
+
+#include "utils.h"
+
+//user function
+__device__ void residual_rms_kernel_gpu( 
+    const double* old_variable,
+    const double* variable,
+    double* residual,
+    double* rms,
+    int* count) {
+    for (int v=0; v<NVAR; v++) {
+        residual[v] = variable[v] - old_variable[v];
+        *rms += residual[v]*residual[v];
+    }
+    #ifdef OPENACC
+
+    #else
+        for (int v=0; v<NVAR; v++) {
+            if (isnan(variable[v]) || isinf(variable[v])) {
+                *count += 1;
+            }
+        }
+    #endif
+
+}
+
+// CUDA kernel function
+__global__ void op_cuda_residual_rms_kernel(
+  const double *__restrict arg0,
+  const double *__restrict arg1,
+  double *arg2,
+  double *arg3,
+  int *arg4,
+  int   set_size ) {
+
+  double arg3_l[1];
+  for ( int d=0; d<1; d++ ){
+    arg3_l[d]=ZERO_double;
+  }
+  int arg4_l[1];
+  for ( int d=0; d<1; d++ ){
+    arg4_l[d]=ZERO_int;
+  }
+
+  //process set elements
+  for ( int n=threadIdx.x+blockIdx.x*blockDim.x; n<set_size; n+=blockDim.x*gridDim.x ){
+
+    //user-supplied kernel call
+    residual_rms_kernel_gpu(arg0+n*5,
+                        arg1+n*5,
+                        arg2+n*5,
+                        arg3_l,
+                        arg4_l);
+  }
+
+  //global reductions
+
+  for ( int d=0; d<1; d++ ){
+    op_reduction<OP_INC>(&arg3[d+blockIdx.x*1],arg3_l[d]);
+  }
+  for ( int d=0; d<1; d++ ){
+    op_reduction<OP_INC>(&arg4[d+blockIdx.x*1],arg4_l[d]);
+  }
+}
+
+
+//host stub function
+void op_par_loop_residual_rms_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  double*arg3h = (double *)arg3.data;
+  int*arg4h = (int *)arg4.data;
+  int nargs = 5;
+  op_arg args[5];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+  args[4] = arg4;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(29);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[29].name      = name;
+  OP_kernels[29].count    += 1;
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  residual_rms_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+  if (set_size > 0) {
+
+    //set CUDA execution parameters
+    #ifdef OP_BLOCK_SIZE_29
+      int nthread = OP_BLOCK_SIZE_29;
+    #else
+      int nthread = OP_block_size;
+    #endif
+
+    int nblocks = 200;
+
+    //transfer global reduction data to GPU
+    int maxblocks = nblocks;
+    int reduct_bytes = 0;
+    int reduct_size  = 0;
+    reduct_bytes += ROUND_UP(maxblocks*1*sizeof(double));
+    reduct_size   = MAX(reduct_size,sizeof(double));
+    reduct_bytes += ROUND_UP(maxblocks*1*sizeof(int));
+    reduct_size   = MAX(reduct_size,sizeof(int));
+    reallocReductArrays(reduct_bytes);
+    reduct_bytes = 0;
+    arg3.data   = OP_reduct_h + reduct_bytes;
+    arg3.data_d = OP_reduct_d + reduct_bytes;
+    for ( int b=0; b<maxblocks; b++ ){
+      for ( int d=0; d<1; d++ ){
+        ((double *)arg3.data)[d+b*1] = ZERO_double;
+      }
+    }
+    reduct_bytes += ROUND_UP(maxblocks*1*sizeof(double));
+    arg4.data   = OP_reduct_h + reduct_bytes;
+    arg4.data_d = OP_reduct_d + reduct_bytes;
+    for ( int b=0; b<maxblocks; b++ ){
+      for ( int d=0; d<1; d++ ){
+        ((int *)arg4.data)[d+b*1] = ZERO_int;
+      }
+    }
+    reduct_bytes += ROUND_UP(maxblocks*1*sizeof(int));
+    mvReductArraysToDevice(reduct_bytes);
+
+    int nshared = reduct_size*nthread;
+    op_cuda_residual_rms_kernel<<<nblocks,nthread,nshared>>>(
+      (double *) arg0.data_d,
+      (double *) arg1.data_d,
+      (double *) arg2.data_d,
+      (double *) arg3.data_d,
+      (int *) arg4.data_d,
+      set->size );
+    //transfer global reduction data back to CPU
+    mvReductArraysToHost(reduct_bytes);
+    for ( int b=0; b<maxblocks; b++ ){
+      for ( int d=0; d<1; d++ ){
+        arg3h[d] = arg3h[d] + ((double *)arg3.data)[d+b*1];
+      }
+    }
+    arg3.data = (char *)arg3h;
+    op_mpi_reduce(&arg3,arg3h);
+    for ( int b=0; b<maxblocks; b++ ){
+      for ( int d=0; d<1; d++ ){
+        arg4h[d] = arg4h[d] + ((int *)arg4.data)[d+b*1];
+      }
+    }
+    arg4.data = (char *)arg4h;
+    op_mpi_reduce(&arg4,arg4h);
+  }
+  op_mpi_set_dirtybit_cuda(nargs, args);
+  cutilSafeCall(cudaDeviceSynchronize());
+  //update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[29].time     += wall_t2 - wall_t1;
+  OP_kernels[29].transfer += (float)set->size * arg0.size;
+  OP_kernels[29].transfer += (float)set->size * arg1.size;
+  OP_kernels[29].transfer += (float)set->size * arg2.size * 2.0f;
+}
@@ -18,14 +18,19 @@ int size, char *dat, char const *name){}
 #include "copy_double_kernel_acckernel.c"
 #include "calculate_dt_kernel_acckernel.c"
 #include "get_min_dt_kernel_acckernel.c"
+#include "copy_calculate_min_dt_kernel_acckernel.c"
 #include "compute_step_factor_kernel_acckernel.c"
 #include "compute_flux_edge_kernel_acckernel.c"
+#include "compute_node_primitives_kernel_acckernel.c"
+#include "compute_flux_edge_primitives_kernel_acckernel.c"
 #include "compute_bnd_node_flux_kernel_acckernel.c"
 #include "time_step_kernel_acckernel.c"
+#include "time_step_min_dt_kernel_acckernel.c"
 #include "indirect_rw_kernel_acckernel.c"
 #include "residual_kernel_acckernel.c"
 #include "calc_rms_kernel_acckernel.c"
 #include "count_bad_vals_acckernel.c"
+#include "residual_rms_kernel_acckernel.c"
 #include "up_pre_kernel_acckernel.c"
 #include "up_kernel_acckernel.c"
 #include "up_post_kernel_acckernel.c"
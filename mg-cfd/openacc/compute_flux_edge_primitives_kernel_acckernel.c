@@ -0,0 +1,208 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+#include <math.h>
+#include "inlined_funcs.h"
+#include "global.h"
+#include "config.h"
+
+//user function
+//#pragma acc routine
+inline void compute_flux_edge_primitives_kernel_openacc( 
+    const double *primitives_a,
+    const double *primitives_b,
+    const double *edge_weight,
+    double *fluxes_a,
+    double *fluxes_b) {
+  double ewt = std::sqrt(edge_weight[0]*edge_weight[0] +
+                         edge_weight[1]*edge_weight[1] +
+                         edge_weight[2]*edge_weight[2]);
+
+  double p_a = primitives_a[PRIM_DENSITY],
+         p_b = primitives_b[PRIM_DENSITY];
+  double pe_a = primitives_a[PRIM_DENSITY_ENERGY],
+         pe_b = primitives_b[PRIM_DENSITY_ENERGY];
+  double3 momentum_a, momentum_b;
+  momentum_a.x = primitives_a[PRIM_MOMENTUM+0];
+  momentum_a.y = primitives_a[PRIM_MOMENTUM+1];
+  momentum_a.z = primitives_a[PRIM_MOMENTUM+2];
+  momentum_b.x = primitives_b[PRIM_MOMENTUM+0];
+  momentum_b.y = primitives_b[PRIM_MOMENTUM+1];
+  momentum_b.z = primitives_b[PRIM_MOMENTUM+2];
+
+  double speed_a = primitives_a[PRIM_SPEED],
+         speed_b = primitives_b[PRIM_SPEED];
+  double speed_of_sound_a = primitives_a[PRIM_SPEED_OF_SOUND],
+         speed_of_sound_b = primitives_b[PRIM_SPEED_OF_SOUND];
+
+  double factor_a = -ewt*smoothing_coefficient*0.5
+                    *(speed_a + speed_b
+                    + speed_of_sound_a + speed_of_sound_b);
+
+  double factor_b = -ewt*smoothing_coefficient*0.5
+                    *(speed_b + speed_a
+                    + speed_of_sound_b + speed_of_sound_a);
+
+  double factor_x = -0.5*edge_weight[0], factor_y = -0.5*edge_weight[1], factor_z = -0.5*edge_weight[2];
+
+  fluxes_a[VAR_DENSITY] +=
+      factor_a*(p_a - p_b)
+    + factor_x*(momentum_a.x + momentum_b.x)
+    + factor_y*(momentum_a.y + momentum_b.y)
+    + factor_z*(momentum_a.z + momentum_b.z);
+
+  fluxes_a[VAR_DENSITY_ENERGY] +=
+      factor_a*(pe_a - pe_b)
+    + factor_x*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+0] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+0])
+    + factor_y*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+1] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+1])
+    + factor_z*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+2] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+2]);
+
+  fluxes_a[VAR_MOMENTUM + 0] +=
+      factor_a*(momentum_a.x - momentum_b.x)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_X+0] + primitives_b[PRIM_FLUX_MOMENTUM_X+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_X+1] + primitives_b[PRIM_FLUX_MOMENTUM_X+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_X+2] + primitives_b[PRIM_FLUX_MOMENTUM_X+2]);
+
+  fluxes_a[VAR_MOMENTUM + 1] +=
+      factor_a*(momentum_a.y - momentum_b.y)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Y+0] + primitives_b[PRIM_FLUX_MOMENTUM_Y+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Y+1] + primitives_b[PRIM_FLUX_MOMENTUM_Y+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Y+2] + primitives_b[PRIM_FLUX_MOMENTUM_Y+2]);
+
+  fluxes_a[VAR_MOMENTUM + 2] +=
+      factor_a*(momentum_a.z - momentum_b.z)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Z+0] + primitives_b[PRIM_FLUX_MOMENTUM_Z+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Z+1] + primitives_b[PRIM_FLUX_MOMENTUM_Z+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Z+2] + primitives_b[PRIM_FLUX_MOMENTUM_Z+2]);
+
+  fluxes_b[VAR_DENSITY] +=
+      factor_b*(p_b - p_a)
+    - factor_x*(momentum_a.x + momentum_b.x)
+    - factor_y*(momentum_a.y + momentum_b.y)
+    - factor_z*(momentum_a.z + momentum_b.z);
+
+  fluxes_b[VAR_DENSITY_ENERGY] +=
+      factor_b*(pe_b - pe_a)
+    - factor_x*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+0] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+0])
+    - factor_y*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+1] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+1])
+    - factor_z*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+2] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+2]);
+
+  fluxes_b[VAR_MOMENTUM + 0] +=
+      factor_b*(momentum_b.x - momentum_a.x)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_X+0] + primitives_b[PRIM_FLUX_MOMENTUM_X+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_X+1] + primitives_b[PRIM_FLUX_MOMENTUM_X+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_X+2] + primitives_b[PRIM_FLUX_MOMENTUM_X+2]);
+
+  fluxes_b[VAR_MOMENTUM + 1] +=
+      factor_b*(momentum_b.y - momentum_a.y)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Y+0] + primitives_b[PRIM_FLUX_MOMENTUM_Y+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Y+1] + primitives_b[PRIM_FLUX_MOMENTUM_Y+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Y+2] + primitives_b[PRIM_FLUX_MOMENTUM_Y+2]);
+
+  fluxes_b[VAR_MOMENTUM + 2] +=
+      factor_b*(momentum_b.z - momentum_a.z)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Z+0] + primitives_b[PRIM_FLUX_MOMENTUM_Z+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Z+1] + primitives_b[PRIM_FLUX_MOMENTUM_Z+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Z+2] + primitives_b[PRIM_FLUX_MOMENTUM_Z+2]);
+}
+
+// host stub function
+void op_par_loop_compute_flux_edge_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  int nargs = 5;
+  op_arg args[5];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+  args[4] = arg4;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(26);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[26].name      = name;
+  OP_kernels[26].count    += 1;
+
+  int  ninds   = 2;
+  int  inds[5] = {0,0,-1,1,1};
+
+  if (OP_diags>2) {
+    printf(" kernel routine with indirection: compute_flux_edge_primitives_kernel\n");
+  }
+
+  // get plan
+  #ifdef OP_PART_SIZE_26
+    int part_size = OP_PART_SIZE_26;
+  #else
+    int part_size = OP_part_size;
+  #endif
+
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+
+
+  int ncolors = 0;
+
+  if (set_size >0) {
+
+
+    //Set up typed device pointers for OpenACC
+    int *map0 = arg0.map_data_d;
+
+    double* data2 = (double*)arg2.data_d;
+    double *data0 = (double *)arg0.data_d;
+    double *data3 = (double *)arg3.data_d;
+
+    op_plan *Plan = op_plan_get_stage(name,set,part_size,nargs,args,ninds,inds,OP_COLOR2);
+    ncolors = Plan->ncolors;
+    int *col_reord = Plan->col_reord;
+    int set_size1 = set->size + set->exec_size;
+
+    // execute plan
+    for ( int col=0; col<Plan->ncolors; col++ ){
+      if (col==1) {
+        op_mpi_wait_all_cuda(nargs, args);
+      }
+      int start = Plan->col_offsets[0][col];
+      int end = Plan->col_offsets[0][col+1];
+
+      #pragma acc parallel loop independent deviceptr(col_reord,map0,data2,data0,data3)
+      for ( int e=start; e<end; e++ ){
+        int n = col_reord[e];
+        int map0idx;
+        int map1idx;
+        map0idx = map0[n + set_size1 * 0];
+        map1idx = map0[n + set_size1 * 1];
+
+
+        compute_flux_edge_primitives_kernel_openacc(
+          &data0[19 * map0idx],
+          &data0[19 * map1idx],
+          &data2[3 * n],
+          &data3[5 * map0idx],
+          &data3[5 * map1idx]);
+      }
+
+    }
+    OP_kernels[26].transfer  += Plan->transfer;
+    OP_kernels[26].transfer2 += Plan->transfer2;
+  }
+
+  if (set_size == 0 || set_size == set->core_size || ncolors == 1) {
+    op_mpi_wait_all_cuda(nargs, args);
+  }
+  // combine reduction data
+  op_mpi_set_dirtybit_cuda(nargs, args);
+
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[26].time     += wall_t2 - wall_t1;
+}
@@ -0,0 +1,110 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+#include <math.h>
+#include "inlined_funcs.h"
+#include "global.h"
+#include "config.h"
+
+//user function
+//#pragma acc routine
+inline void compute_node_primitives_kernel_openacc( 
+    const double *variables,
+    double *primitives) {
+  double p = variables[VAR_DENSITY];
+
+  #ifdef IDIVIDE
+  double ip = 1.0 / p;
+  #endif
+
+  double pe, pressure;
+  double3 velocity, momentum;
+
+  momentum.x = variables[VAR_MOMENTUM+0];
+  momentum.y = variables[VAR_MOMENTUM+1];
+  momentum.z = variables[VAR_MOMENTUM+2];
+  pe = variables[VAR_DENSITY_ENERGY];
+
+  #ifdef IDIVIDE
+  compute_velocity(ip, momentum, velocity);
+  #else
+  compute_velocity(p, momentum, velocity);
+  #endif
+
+  double speed_sqd = compute_speed_sqd(velocity);
+
+  pressure = compute_pressure(p, pe, speed_sqd);
+
+  primitives[PRIM_DENSITY]        = p;
+  primitives[PRIM_MOMENTUM+0]     = momentum.x;
+  primitives[PRIM_MOMENTUM+1]     = momentum.y;
+  primitives[PRIM_MOMENTUM+2]     = momentum.z;
+  primitives[PRIM_DENSITY_ENERGY] = pe;
+  primitives[PRIM_SPEED]          = std::sqrt(speed_sqd);
+
+  #ifdef IDIVIDE
+  primitives[PRIM_SPEED_OF_SOUND] = compute_speed_of_sound(ip, pressure);
+  #else
+  primitives[PRIM_SPEED_OF_SOUND] = compute_speed_of_sound(p, pressure);
+  #endif
+
+  compute_flux_contribution(p, momentum, pe,
+                            pressure, velocity,
+                            &primitives[PRIM_FLUX_MOMENTUM_X],
+                            &primitives[PRIM_FLUX_MOMENTUM_Y],
+                            &primitives[PRIM_FLUX_MOMENTUM_Z],
+                            &primitives[PRIM_FLUX_DENSITY_ENERGY]);
+}
+
+// host stub function
+void op_par_loop_compute_node_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1){
+
+  int nargs = 2;
+  op_arg args[2];
+
+  args[0] = arg0;
+  args[1] = arg1;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(25);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[25].name      = name;
+  OP_kernels[25].count    += 1;
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  compute_node_primitives_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+
+
+  if (set_size >0) {
+
+
+    //Set up typed device pointers for OpenACC
+
+    double* data0 = (double*)arg0.data_d;
+    double* data1 = (double*)arg1.data_d;
+    #pragma acc parallel loop independent deviceptr(data0,data1)
+    for ( int n=0; n<set->size; n++ ){
+      compute_node_primitives_kernel_openacc(
+        &data0[5*n],
+        &data1[19*n]);
+    }
+  }
+
+  // combine reduction data
+  op_mpi_set_dirtybit_cuda(nargs, args);
+
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[25].time     += wall_t2 - wall_t1;
+  OP_kernels[25].transfer += (float)set->size * arg0.size;
+  OP_kernels[25].transfer += (float)set->size * arg1.size * 2.0f;
+}
@@ -0,0 +1,105 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+#include <math.h>
+#include <cmath>
+#include "const.h"
+#include "inlined_funcs.h"
+
+//user function
+//#pragma acc routine
+inline void copy_calculate_min_dt_kernel_openacc( 
+    const double* variable,
+    const double* volume,
+    double* old_variable,
+    double* min_dt) {
+    double density = variable[VAR_DENSITY];
+
+    double3 momentum;
+    momentum.x = variable[VAR_MOMENTUM+0];
+    momentum.y = variable[VAR_MOMENTUM+1];
+    momentum.z = variable[VAR_MOMENTUM+2];
+
+    double density_energy = variable[VAR_DENSITY_ENERGY];
+
+    old_variable[VAR_DENSITY]        = density;
+    old_variable[VAR_MOMENTUM+0]     = momentum.x;
+    old_variable[VAR_MOMENTUM+1]     = momentum.y;
+    old_variable[VAR_MOMENTUM+2]     = momentum.z;
+    old_variable[VAR_DENSITY_ENERGY] = density_energy;
+
+    double3 velocity; compute_velocity(density, momentum, velocity);
+    double speed_sqd      = compute_speed_sqd(velocity);
+    double pressure       = compute_pressure(density, density_energy, speed_sqd);
+    double speed_of_sound = compute_speed_of_sound(density, pressure);
+
+    double dt = double(0.5) * (cbrt(*volume) / (sqrt(speed_sqd) + speed_of_sound));
+    if (dt < (*min_dt)) {
+        *min_dt = dt;
+    }
+}
+
+// host stub function
+void op_par_loop_copy_calculate_min_dt_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3){
+
+  double*arg3h = (double *)arg3.data;
+  int nargs = 4;
+  op_arg args[4];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(27);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[27].name      = name;
+  OP_kernels[27].count    += 1;
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  copy_calculate_min_dt_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+
+  double arg3_l = arg3h[0];
+
+  if (set_size >0) {
+
+
+    //Set up typed device pointers for OpenACC
+
+    double* data0 = (double*)arg0.data_d;
+    double* data1 = (double*)arg1.data_d;
+    double* data2 = (double*)arg2.data_d;
+    #pragma acc parallel loop independent deviceptr(data0,data1,data2) reduction(min:arg3_l)
+    for ( int n=0; n<set->size; n++ ){
+      copy_calculate_min_dt_kernel_openacc(
+        &data0[5*n],
+        &data1[1*n],
+        &data2[5*n],
+        &arg3_l);
+    }
+  }
+
+  // combine reduction data
+  arg3h[0]  = MIN(arg3h[0],arg3_l);
+  op_mpi_reduce_double(&arg3,arg3h);
+  op_mpi_set_dirtybit_cuda(nargs, args);
+
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[27].time     += wall_t2 - wall_t1;
+  OP_kernels[27].transfer += (float)set->size * arg0.size;
+  OP_kernels[27].transfer += (float)set->size * arg1.size;
+  OP_kernels[27].transfer += (float)set->size * arg2.size * 2.0f;
+}
@@ -0,0 +1,104 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+#include <math.h>
+#include <cmath>
+#include "const.h"
+#include "inlined_funcs.h"
+
+//user function
+//#pragma acc routine
+inline void time_step_min_dt_kernel_openacc( 
+    const int* rkCycle,
+    const double* min_dt,
+    const double* volume,
+    double* flux,
+    const double* old_variable,
+    double* variable) {
+    double factor = ((*min_dt) / (*volume))/double(RK+1-(*rkCycle));
+
+    variable[VAR_DENSITY]        = old_variable[VAR_DENSITY]        + factor*flux[VAR_DENSITY];
+    variable[VAR_MOMENTUM+0]     = old_variable[VAR_MOMENTUM+0]     + factor*flux[VAR_MOMENTUM+0];
+    variable[VAR_MOMENTUM+1]     = old_variable[VAR_MOMENTUM+1]     + factor*flux[VAR_MOMENTUM+1];
+    variable[VAR_MOMENTUM+2]     = old_variable[VAR_MOMENTUM+2]     + factor*flux[VAR_MOMENTUM+2];
+    variable[VAR_DENSITY_ENERGY] = old_variable[VAR_DENSITY_ENERGY] + factor*flux[VAR_DENSITY_ENERGY];
+
+    flux[VAR_DENSITY]        = 0.0;
+    flux[VAR_MOMENTUM+0]     = 0.0;
+    flux[VAR_MOMENTUM+1]     = 0.0;
+    flux[VAR_MOMENTUM+2]     = 0.0;
+    flux[VAR_DENSITY_ENERGY] = 0.0;
+}
+
+// host stub function
+void op_par_loop_time_step_min_dt_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4,
+  op_arg arg5){
+
+  int*arg0h = (int *)arg0.data;
+  double*arg1h = (double *)arg1.data;
+  int nargs = 6;
+  op_arg args[6];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+  args[4] = arg4;
+  args[5] = arg5;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(28);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[28].name      = name;
+  OP_kernels[28].count    += 1;
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  time_step_min_dt_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+
+  int arg0_l = arg0h[0];
+  double arg1_l = arg1h[0];
+
+  if (set_size >0) {
+
+
+    //Set up typed device pointers for OpenACC
+
+    double* data2 = (double*)arg2.data_d;
+    double* data3 = (double*)arg3.data_d;
+    double* data4 = (double*)arg4.data_d;
+    double* data5 = (double*)arg5.data_d;
+    #pragma acc parallel loop independent deviceptr(data2,data3,data4,data5)
+    for ( int n=0; n<set->size; n++ ){
+      time_step_min_dt_kernel_openacc(
+        &arg0_l,
+        &arg1_l,
+        &data2[1*n],
+        &data3[5*n],
+        &data4[5*n],
+        &data5[5*n]);
+    }
+  }
+
+  // combine reduction data
+  op_mpi_set_dirtybit_cuda(nargs, args);
+
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[28].time     += wall_t2 - wall_t1;
+  OP_kernels[28].transfer += (float)set->size * arg2.size;
+  OP_kernels[28].transfer += (float)set->size * arg3.size * 2.0f;
+  OP_kernels[28].transfer += (float)set->size * arg4.size;
+  OP_kernels[28].transfer += (float)set->size * arg5.size * 2.0f;
+}
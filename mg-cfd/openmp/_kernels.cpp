@@ -20,14 +20,19 @@
 #include "copy_double_kernel_kernel.cpp"
 #include "calculate_dt_kernel_kernel.cpp"
 #include "get_min_dt_kernel_kernel.cpp"
+#include "copy_calculate_min_dt_kernel_kernel.cpp"
 #include "compute_step_factor_kernel_kernel.cpp"
 #include "compute_flux_edge_kernel_kernel.cpp"
+#include "compute_node_primitives_kernel_kernel.cpp"
+#include "compute_flux_edge_primitives_kernel_kernel.cpp"
 #include "compute_bnd_node_flux_kernel_kernel.cpp"
 #include "time_step_kernel_kernel.cpp"
+#include "time_step_min_dt_kernel_kernel.cpp"
 #include "indirect_rw_kernel_kernel.cpp"
 #include "residual_kernel_kernel.cpp"
 #include "calc_rms_kernel_kernel.cpp"
 #include "count_bad_vals_kernel.cpp"
+#include "residual_rms_kernel_kernel.cpp"
 #include "up_pre_kernel_kernel.cpp"
 #include "up_kernel_kernel.cpp"
 #include "up_post_kernel_kernel.cpp"
@@ -37,3 +42,6 @@
 #include "down_kernel_kernel.cpp"
 #include "identify_differences_kernel.cpp"
 #include "count_non_zeros_kernel.cpp"
+
+// sparse-tiled loop chains
+#include "sparse_tiled_rk_stage_kernel.cpp"
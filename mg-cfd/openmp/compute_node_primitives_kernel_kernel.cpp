@@ -0,0 +1,62 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+#include ".././src/Kernels/flux.h"
+
+// host stub function
+void op_par_loop_compute_node_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1){
+
+  int nargs = 2;
+  op_arg args[2];
+
+  args[0] = arg0;
+  args[1] = arg1;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(25);
+  OP_kernels[25].name      = name;
+  OP_kernels[25].count    += 1;
+  op_timers_core(&cpu_t1, &wall_t1);
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  compute_node_primitives_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges(set, nargs, args);
+  // set number of threads
+  #ifdef _OPENMP
+    int nthreads = omp_get_max_threads();
+  #else
+    int nthreads = 1;
+  #endif
+
+  if (set_size >0) {
+
+    // execute plan
+    #pragma omp parallel for
+    for ( int thr=0; thr<nthreads; thr++ ){
+      int start  = (set->size* thr)/nthreads;
+      int finish = (set->size*(thr+1))/nthreads;
+      for ( int n=start; n<finish; n++ ){
+        compute_node_primitives_kernel(
+          &((double*)arg0.data)[5*n],
+          &((double*)arg1.data)[19*n]);
+      }
+    }
+  }
+
+  // combine reduction data
+  op_mpi_set_dirtybit(nargs, args);
+
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[25].time     += wall_t2 - wall_t1;
+  OP_kernels[25].transfer += (float)set->size * arg0.size;
+  OP_kernels[25].transfer += (float)set->size * arg1.size * 2.0f;
+}
@@ -0,0 +1,84 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+#include ".././src/Kernels/time_stepping_kernels.h"
+
+// host stub function
+void op_par_loop_copy_calculate_min_dt_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3){
+
+  double*arg3h = (double *)arg3.data;
+  int nargs = 4;
+  op_arg args[4];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(27);
+  OP_kernels[27].name      = name;
+  OP_kernels[27].count    += 1;
+  op_timers_core(&cpu_t1, &wall_t1);
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  copy_calculate_min_dt_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges(set, nargs, args);
+  // set number of threads
+  #ifdef _OPENMP
+    int nthreads = omp_get_max_threads();
+  #else
+    int nthreads = 1;
+  #endif
+
+  // allocate and initialise arrays for global reduction
+  double arg3_l[nthreads*64];
+  for ( int thr=0; thr<nthreads; thr++ ){
+    for ( int d=0; d<1; d++ ){
+      arg3_l[d+thr*64]=arg3h[d];
+    }
+  }
+
+  if (set_size >0) {
+
+    // execute plan
+    #pragma omp parallel for
+    for ( int thr=0; thr<nthreads; thr++ ){
+      int start  = (set->size* thr)/nthreads;
+      int finish = (set->size*(thr+1))/nthreads;
+      for ( int n=start; n<finish; n++ ){
+        copy_calculate_min_dt_kernel(
+          &((double*)arg0.data)[5*n],
+          &((double*)arg1.data)[1*n],
+          &((double*)arg2.data)[5*n],
+          &arg3_l[64*omp_get_thread_num()]);
+      }
+    }
+  }
+
+  // combine reduction data
+  for ( int thr=0; thr<nthreads; thr++ ){
+    for ( int d=0; d<1; d++ ){
+      arg3h[d]  = MIN(arg3h[d],arg3_l[d+thr*64]);
+    }
+  }
+  op_mpi_reduce(&arg3,arg3h);
+  op_mpi_set_dirtybit(nargs, args);
+
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[27].time     += wall_t2 - wall_t1;
+  OP_kernels[27].transfer += (float)set->size * arg0.size;
+  OP_kernels[27].transfer += (float)set->size * arg1.size;
+  OP_kernels[27].transfer += (float)set->size * arg2.size * 2.0f;
+}
@@ -0,0 +1,141 @@
+//
+// sparse-tiled loop chain, not generated by op2.py
+//
+
+//user functions
+#include ".././src/Kernels/flux.h"
+#include ".././src/Kernels/time_stepping_kernels.h"
+#include ".././src/sparse_tiling.h"
+
+#include <map>
+#include <memory>
+
+// Runs one RK stage, the chain
+//   compute_flux_edge_kernel (or compute_flux_edge_primitives_kernel)
+//   compute_bnd_node_flux_kernel
+//   time_step_min_dt_kernel
+// tile by tile instead of loop by loop. Arguments are those of the three
+// op_par_loop calls it replaces, in order.
+void op_par_loop_sparse_tiled_rk_stage(char const *name, int tile_size, bool primitives,
+  op_set edges,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4,
+  op_set bnd_nodes,
+  op_arg arg5,
+  op_arg arg6,
+  op_arg arg7,
+  op_arg arg8,
+  op_set nodes,
+  op_arg arg9,
+  op_arg arg10,
+  op_arg arg11,
+  op_arg arg12,
+  op_arg arg13,
+  op_arg arg14){
+
+  op_arg edge_args[5] = {arg0, arg1, arg2, arg3, arg4};
+  op_arg bnd_args[4] = {arg5, arg6, arg7, arg8};
+  op_arg node_args[6] = {arg9, arg10, arg11, arg12, arg13, arg14};
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(30);
+  OP_kernels[30].name      = name;
+  OP_kernels[30].count    += 1;
+  op_timers_core(&cpu_t1, &wall_t1);
+
+  if (OP_diags>2) {
+    printf(" sparse-tiled loop chain: %s\n", name);
+  }
+
+  // The whole chain runs between one halo exchange and the next, so there
+  // is no overlap of communication with the core elements
+  int edge_size = op_mpi_halo_exchanges(edges, 5, edge_args);
+  op_mpi_wait_all(5, edge_args);
+  int bnd_size = op_mpi_halo_exchanges(bnd_nodes, 4, bnd_args);
+  op_mpi_wait_all(4, bnd_args);
+  op_mpi_halo_exchanges(nodes, 6, node_args);
+  int node_size = nodes->size;
+
+  // Plans depend only on the maps, so are built once per level and freed
+  // at exit
+  static std::map<op_set, std::unique_ptr<sparse_tile_plan> > plans;
+  sparse_tile_plan* plan = plans[edges].get();
+  if (plan == NULL) {
+    int num_nodes = node_size;
+    for (int n=0; n<2*edge_size; n++) {
+      num_nodes = MAX(num_nodes, arg0.map_data[n]+1);
+    }
+    for (int n=0; n<bnd_size; n++) {
+      num_nodes = MAX(num_nodes, arg7.map_data[n]+1);
+    }
+    plan = new sparse_tile_plan;
+    plans[edges].reset(plan);
+    sparse_tile_plan_build(plan, MAX(tile_size, 1), num_nodes, edge_size, arg0.map_data, bnd_size, arg7.map_data);
+    if (OP_diags>1) {
+      printf(" %s on %s: %d tiles in %d colours\n", name, edges->name, plan->ntiles, plan->ncolors);
+    }
+  }
+
+  const int dim0 = arg0.dim;
+  for ( int col=0; col<plan->ncolors; col++ ){
+    #pragma omp parallel for schedule(dynamic)
+    for ( int i=plan->color_offsets[col]; i<plan->color_offsets[col+1]; i++ ){
+      int tile = plan->tiles[i];
+
+      for ( int k=plan->edge_offsets[tile]; k<plan->edge_offsets[tile+1]; k++ ){
+        int n = plan->edges[k];
+        int map0idx = arg0.map_data[n * arg0.map->dim + 0];
+        int map1idx = arg0.map_data[n * arg0.map->dim + 1];
+        if (primitives) {
+          compute_flux_edge_primitives_kernel(
+            &((double*)arg0.data)[dim0 * map0idx],
+            &((double*)arg0.data)[dim0 * map1idx],
+            &((double*)arg2.data)[3 * n],
+            &((double*)arg3.data)[5 * map0idx],
+            &((double*)arg3.data)[5 * map1idx]);
+        } else {
+          compute_flux_edge_kernel(
+            &((double*)arg0.data)[dim0 * map0idx],
+            &((double*)arg0.data)[dim0 * map1idx],
+            &((double*)arg2.data)[3 * n],
+            &((double*)arg3.data)[5 * map0idx],
+            &((double*)arg3.data)[5 * map1idx]);
+        }
+      }
+
+      for ( int k=plan->bnd_node_offsets[tile]; k<plan->bnd_node_offsets[tile+1]; k++ ){
+        int n = plan->bnd_nodes[k];
+        int map7idx = arg7.map_data[n * arg7.map->dim + 0];
+        compute_bnd_node_flux_kernel(
+          &((int*)arg5.data)[1 * n],
+          &((double*)arg6.data)[3 * n],
+          &((double*)arg7.data)[5 * map7idx],
+          &((double*)arg8.data)[5 * map7idx]);
+      }
+
+      int start  = MIN(tile * plan->tile_size, node_size);
+      int finish = MIN(start + plan->tile_size, node_size);
+      for ( int n=start; n<finish; n++ ){
+        time_step_min_dt_kernel(
+          (int*)arg9.data,
+          (double*)arg10.data,
+          &((double*)arg11.data)[1*n],
+          &((double*)arg12.data)[5*n],
+          &((double*)arg13.data)[5*n],
+          &((double*)arg14.data)[5*n]);
+      }
+    }
+  }
+
+  op_mpi_set_dirtybit(5, edge_args);
+  op_mpi_set_dirtybit(4, bnd_args);
+  op_mpi_set_dirtybit(6, node_args);
+
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[30].time     += wall_t2 - wall_t1;
+}
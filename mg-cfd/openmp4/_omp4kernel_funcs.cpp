@@ -48,14 +48,19 @@ void op_decl_const_char(int dim, char const *type,
 #include "copy_double_kernel_omp4kernel_func.cpp"
 #include "calculate_dt_kernel_omp4kernel_func.cpp"
 #include "get_min_dt_kernel_omp4kernel_func.cpp"
+#include "copy_calculate_min_dt_kernel_omp4kernel_func.cpp"
 #include "compute_step_factor_kernel_omp4kernel_func.cpp"
 #include "compute_flux_edge_kernel_omp4kernel_func.cpp"
+#include "compute_node_primitives_kernel_omp4kernel_func.cpp"
+#include "compute_flux_edge_primitives_kernel_omp4kernel_func.cpp"
 #include "compute_bnd_node_flux_kernel_omp4kernel_func.cpp"
 #include "time_step_kernel_omp4kernel_func.cpp"
+#include "time_step_min_dt_kernel_omp4kernel_func.cpp"
 #include "indirect_rw_kernel_omp4kernel_func.cpp"
 #include "residual_kernel_omp4kernel_func.cpp"
 #include "calc_rms_kernel_omp4kernel_func.cpp"
 #include "count_bad_vals_omp4kernel_func.cpp"
+#include "residual_rms_kernel_omp4kernel_func.cpp"
 #include "up_pre_kernel_omp4kernel_func.cpp"
 #include "up_kernel_omp4kernel_func.cpp"
 #include "up_post_kernel_omp4kernel_func.cpp"
@@ -14,14 +14,19 @@
 #include "copy_double_kernel_omp4kernel.cpp"
 #include "calculate_dt_kernel_omp4kernel.cpp"
 #include "get_min_dt_kernel_omp4kernel.cpp"
+#include "copy_calculate_min_dt_kernel_omp4kernel.cpp"
 #include "compute_step_factor_kernel_omp4kernel.cpp"
 #include "compute_flux_edge_kernel_omp4kernel.cpp"
+#include "compute_node_primitives_kernel_omp4kernel.cpp"
+#include "compute_flux_edge_primitives_kernel_omp4kernel.cpp"
 #include "compute_bnd_node_flux_kernel_omp4kernel.cpp"
 #include "time_step_kernel_omp4kernel.cpp"
+#include "time_step_min_dt_kernel_omp4kernel.cpp"
 #include "indirect_rw_kernel_omp4kernel.cpp"
 #include "residual_kernel_omp4kernel.cpp"
 #include "calc_rms_kernel_omp4kernel.cpp"
 #include "count_bad_vals_omp4kernel.cpp"
+#include "residual_rms_kernel_omp4kernel.cpp"
 #include "up_pre_kernel_omp4kernel.cpp"
 #include "up_kernel_omp4kernel.cpp"
 #include "up_post_kernel_omp4kernel.cpp"
@@ -0,0 +1,129 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+//user function
+
+void compute_flux_edge_primitives_kernel_omp4_kernel(
+  int *map0,
+  int map0size,
+  double *data2,
+  int dat2size,
+  double *data0,
+  int dat0size,
+  double *data3,
+  int dat3size,
+  int *col_reord,
+  int set_size1,
+  int start,
+  int end,
+  int num_teams,
+  int nthread);
+
+// host stub function
+void op_par_loop_compute_flux_edge_primitives_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  int nargs = 5;
+  op_arg args[5];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+  args[4] = arg4;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(26);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[26].name      = name;
+  OP_kernels[26].count    += 1;
+
+  int  ninds   = 2;
+  int  inds[5] = {0,0,-1,1,1};
+
+  if (OP_diags>2) {
+    printf(" kernel routine with indirection: compute_flux_edge_primitives_kernel\n");
+  }
+
+  // get plan
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+
+  #ifdef OP_PART_SIZE_26
+    int part_size = OP_PART_SIZE_26;
+  #else
+    int part_size = OP_part_size;
+  #endif
+  #ifdef OP_BLOCK_SIZE_26
+    int nthread = OP_BLOCK_SIZE_26;
+  #else
+    int nthread = OP_block_size;
+  #endif
+
+
+  int ncolors = 0;
+  int set_size1 = set->size + set->exec_size;
+
+  if (set_size >0) {
+
+    //Set up typed device pointers for OpenMP
+    int *map0 = arg0.map_data_d;
+     int map0size = arg0.map->dim * set_size1;
+
+    double* data2 = (double*)arg2.data_d;
+    int dat2size = getSetSizeFromOpArg(&arg2) * arg2.dat->dim;
+    double *data0 = (double *)arg0.data_d;
+    int dat0size = getSetSizeFromOpArg(&arg0) * arg0.dat->dim;
+    double *data3 = (double *)arg3.data_d;
+    int dat3size = getSetSizeFromOpArg(&arg3) * arg3.dat->dim;
+
+    op_plan *Plan = op_plan_get_stage(name,set,part_size,nargs,args,ninds,inds,OP_COLOR2);
+    ncolors = Plan->ncolors;
+    int *col_reord = Plan->col_reord;
+
+    // execute plan
+    for ( int col=0; col<Plan->ncolors; col++ ){
+      if (col==1) {
+        op_mpi_wait_all_cuda(nargs, args);
+      }
+      int start = Plan->col_offsets[0][col];
+      int end = Plan->col_offsets[0][col+1];
+
+      compute_flux_edge_primitives_kernel_omp4_kernel(
+        map0,
+        map0size,
+        data2,
+        dat2size,
+        data0,
+        dat0size,
+        data3,
+        dat3size,
+        col_reord,
+        set_size1,
+        start,
+        end,
+        part_size!=0?(end-start-1)/part_size+1:(end-start-1)/nthread,
+        nthread);
+
+    }
+    OP_kernels[26].transfer  += Plan->transfer;
+    OP_kernels[26].transfer2 += Plan->transfer2;
+  }
+
+  if (set_size == 0 || set_size == set->core_size || ncolors == 1) {
+    op_mpi_wait_all_cuda(nargs, args);
+  }
+  // combine reduction data
+  op_mpi_set_dirtybit_cuda(nargs, args);
+
+  if (OP_diags>1) deviceSync();
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[26].time     += wall_t2 - wall_t1;
+}
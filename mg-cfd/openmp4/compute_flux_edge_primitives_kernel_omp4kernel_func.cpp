@@ -0,0 +1,139 @@
+//
+// auto-generated by op2.py
+//
+
+#include <math.h>
+#include "inlined_funcs.h"
+#include "global.h"
+#include "config.h"
+
+void compute_flux_edge_primitives_kernel_omp4_kernel(
+  int *map0,
+  int map0size,
+  double *data2,
+  int dat2size,
+  double *data0,
+  int dat0size,
+  double *data3,
+  int dat3size,
+  int *col_reord,
+  int set_size1,
+  int start,
+  int end,
+  int num_teams,
+  int nthread){
+
+  #pragma omp target teams num_teams(num_teams) thread_limit(nthread) map(to:data2[0:dat2size]) \
+    map(to: smoothing_coefficient_ompkernel)\
+    map(to:col_reord[0:set_size1],map0[0:map0size],data0[0:dat0size],data3[0:dat3size])
+  #pragma omp distribute parallel for schedule(static,1)
+  for ( int e=start; e<end; e++ ){
+    int n_op = col_reord[e];
+    int map0idx;
+    int map1idx;
+    map0idx = map0[n_op + set_size1 * 0];
+    map1idx = map0[n_op + set_size1 * 1];
+
+    //variable mapping
+    const double *primitives_a = &data0[19 * map0idx];
+    const double *primitives_b = &data0[19 * map1idx];
+    const double *edge_weight = &data2[3*n_op];
+    double *fluxes_a = &data3[5 * map0idx];
+    double *fluxes_b = &data3[5 * map1idx];
+
+    //inline function
+    
+    double ewt = std::sqrt(edge_weight[0]*edge_weight[0] +
+                           edge_weight[1]*edge_weight[1] +
+                           edge_weight[2]*edge_weight[2]);
+
+    double p_a = primitives_a[PRIM_DENSITY],
+           p_b = primitives_b[PRIM_DENSITY];
+    double pe_a = primitives_a[PRIM_DENSITY_ENERGY],
+           pe_b = primitives_b[PRIM_DENSITY_ENERGY];
+    double3 momentum_a, momentum_b;
+    momentum_a.x = primitives_a[PRIM_MOMENTUM+0];
+    momentum_a.y = primitives_a[PRIM_MOMENTUM+1];
+    momentum_a.z = primitives_a[PRIM_MOMENTUM+2];
+    momentum_b.x = primitives_b[PRIM_MOMENTUM+0];
+    momentum_b.y = primitives_b[PRIM_MOMENTUM+1];
+    momentum_b.z = primitives_b[PRIM_MOMENTUM+2];
+
+    double speed_a = primitives_a[PRIM_SPEED],
+           speed_b = primitives_b[PRIM_SPEED];
+    double speed_of_sound_a = primitives_a[PRIM_SPEED_OF_SOUND],
+           speed_of_sound_b = primitives_b[PRIM_SPEED_OF_SOUND];
+
+    double factor_a = -ewt*smoothing_coefficient_ompkernel*0.5
+                      *(speed_a + speed_b
+                      + speed_of_sound_a + speed_of_sound_b);
+
+    double factor_b = -ewt*smoothing_coefficient_ompkernel*0.5
+                      *(speed_b + speed_a
+                      + speed_of_sound_b + speed_of_sound_a);
+
+    double factor_x = -0.5*edge_weight[0], factor_y = -0.5*edge_weight[1], factor_z = -0.5*edge_weight[2];
+
+    fluxes_a[VAR_DENSITY] +=
+        factor_a*(p_a - p_b)
+      + factor_x*(momentum_a.x + momentum_b.x)
+      + factor_y*(momentum_a.y + momentum_b.y)
+      + factor_z*(momentum_a.z + momentum_b.z);
+
+    fluxes_a[VAR_DENSITY_ENERGY] +=
+        factor_a*(pe_a - pe_b)
+      + factor_x*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+0] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+0])
+      + factor_y*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+1] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+1])
+      + factor_z*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+2] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+2]);
+
+    fluxes_a[VAR_MOMENTUM + 0] +=
+        factor_a*(momentum_a.x - momentum_b.x)
+      + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_X+0] + primitives_b[PRIM_FLUX_MOMENTUM_X+0])
+      + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_X+1] + primitives_b[PRIM_FLUX_MOMENTUM_X+1])
+      + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_X+2] + primitives_b[PRIM_FLUX_MOMENTUM_X+2]);
+
+    fluxes_a[VAR_MOMENTUM + 1] +=
+        factor_a*(momentum_a.y - momentum_b.y)
+      + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Y+0] + primitives_b[PRIM_FLUX_MOMENTUM_Y+0])
+      + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Y+1] + primitives_b[PRIM_FLUX_MOMENTUM_Y+1])
+      + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Y+2] + primitives_b[PRIM_FLUX_MOMENTUM_Y+2]);
+
+    fluxes_a[VAR_MOMENTUM + 2] +=
+        factor_a*(momentum_a.z - momentum_b.z)
+      + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Z+0] + primitives_b[PRIM_FLUX_MOMENTUM_Z+0])
+      + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Z+1] + primitives_b[PRIM_FLUX_MOMENTUM_Z+1])
+      + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Z+2] + primitives_b[PRIM_FLUX_MOMENTUM_Z+2]);
+
+    fluxes_b[VAR_DENSITY] +=
+        factor_b*(p_b - p_a)
+      - factor_x*(momentum_a.x + momentum_b.x)
+      - factor_y*(momentum_a.y + momentum_b.y)
+      - factor_z*(momentum_a.z + momentum_b.z);
+
+    fluxes_b[VAR_DENSITY_ENERGY] +=
+        factor_b*(pe_b - pe_a)
+      - factor_x*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+0] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+0])
+      - factor_y*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+1] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+1])
+      - factor_z*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+2] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+2]);
+
+    fluxes_b[VAR_MOMENTUM + 0] +=
+        factor_b*(momentum_b.x - momentum_a.x)
+      - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_X+0] + primitives_b[PRIM_FLUX_MOMENTUM_X+0])
+      - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_X+1] + primitives_b[PRIM_FLUX_MOMENTUM_X+1])
+      - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_X+2] + primitives_b[PRIM_FLUX_MOMENTUM_X+2]);
+
+    fluxes_b[VAR_MOMENTUM + 1] +=
+        factor_b*(momentum_b.y - momentum_a.y)
+      - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Y+0] + primitives_b[PRIM_FLUX_MOMENTUM_Y+0])
+      - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Y+1] + primitives_b[PRIM_FLUX_MOMENTUM_Y+1])
+      - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Y+2] + primitives_b[PRIM_FLUX_MOMENTUM_Y+2]);
+
+    fluxes_b[VAR_MOMENTUM + 2] +=
+        factor_b*(momentum_b.z - momentum_a.z)
+      - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Z+0] + primitives_b[PRIM_FLUX_MOMENTUM_Z+0])
+      - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Z+1] + primitives_b[PRIM_FLUX_MOMENTUM_Z+1])
+      - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Z+2] + primitives_b[PRIM_FLUX_MOMENTUM_Z+2]);
+    //end inline func
+  }
+
+}
@@ -0,0 +1,74 @@
+//
+// auto-generated by op2.py
+//
+
+#include <math.h>
+#include "inlined_funcs.h"
+#include "global.h"
+#include "config.h"
+
+void compute_node_primitives_kernel_omp4_kernel(
+  double *data0,
+  int dat0size,
+  double *data1,
+  int dat1size,
+  int count,
+  int num_teams,
+  int nthread){
+
+  #pragma omp target teams num_teams(num_teams) thread_limit(nthread) map(to:data0[0:dat0size],data1[0:dat1size])
+  #pragma omp distribute parallel for schedule(static,1)
+  for ( int n_op=0; n_op<count; n_op++ ){
+    //variable mapping
+    const double *variables = &data0[5*n_op];
+    double *primitives = &data1[19*n_op];
+
+    //inline function
+    
+    double p = variables[VAR_DENSITY];
+
+    #ifdef IDIVIDE
+    double ip = 1.0 / p;
+    #endif
+
+    double pe, pressure;
+    double3 velocity, momentum;
+
+    momentum.x = variables[VAR_MOMENTUM+0];
+    momentum.y = variables[VAR_MOMENTUM+1];
+    momentum.z = variables[VAR_MOMENTUM+2];
+    pe = variables[VAR_DENSITY_ENERGY];
+
+    #ifdef IDIVIDE
+    compute_velocity(ip, momentum, velocity);
+    #else
+    compute_velocity(p, momentum, velocity);
+    #endif
+
+    double speed_sqd = compute_speed_sqd(velocity);
+
+    pressure = compute_pressure(p, pe, speed_sqd);
+
+    primitives[PRIM_DENSITY]        = p;
+    primitives[PRIM_MOMENTUM+0]     = momentum.x;
+    primitives[PRIM_MOMENTUM+1]     = momentum.y;
+    primitives[PRIM_MOMENTUM+2]     = momentum.z;
+    primitives[PRIM_DENSITY_ENERGY] = pe;
+    primitives[PRIM_SPEED]          = std::sqrt(speed_sqd);
+
+    #ifdef IDIVIDE
+    primitives[PRIM_SPEED_OF_SOUND] = compute_speed_of_sound(ip, pressure);
+    #else
+    primitives[PRIM_SPEED_OF_SOUND] = compute_speed_of_sound(p, pressure);
+    #endif
+
+    compute_flux_contribution(p, momentum, pe,
+                              pressure, velocity,
+                              &primitives[PRIM_FLUX_MOMENTUM_X],
+                              &primitives[PRIM_FLUX_MOMENTUM_Y],
+                              &primitives[PRIM_FLUX_MOMENTUM_Z],
+                              &primitives[PRIM_FLUX_DENSITY_ENERGY]);
+    //end inline func
+  }
+
+}
@@ -0,0 +1,63 @@
+//
+// auto-generated by op2.py
+//
+
+#include <math.h>
+#include <cmath>
+#include "const.h"
+#include "inlined_funcs.h"
+
+void copy_calculate_min_dt_kernel_omp4_kernel(
+  double *data0,
+  int dat0size,
+  double *data1,
+  int dat1size,
+  double *data2,
+  int dat2size,
+  double *arg3,
+  int count,
+  int num_teams,
+  int nthread){
+
+  double arg3_l = *arg3;
+  #pragma omp target teams num_teams(num_teams) thread_limit(nthread) map(to:data0[0:dat0size],data1[0:dat1size],data2[0:dat2size])\
+    map(tofrom: arg3_l) reduction(min:arg3_l)
+  #pragma omp distribute parallel for schedule(static,1) reduction(min:arg3_l)
+  for ( int n_op=0; n_op<count; n_op++ ){
+    //variable mapping
+    const double* variable = &data0[5*n_op];
+    const double* volume = &data1[1*n_op];
+    double* old_variable = &data2[5*n_op];
+    double* min_dt = &arg3_l;
+
+    //inline function
+    
+      double density = variable[VAR_DENSITY];
+
+      double3 momentum;
+      momentum.x = variable[VAR_MOMENTUM+0];
+      momentum.y = variable[VAR_MOMENTUM+1];
+      momentum.z = variable[VAR_MOMENTUM+2];
+
+      double density_energy = variable[VAR_DENSITY_ENERGY];
+
+      old_variable[VAR_DENSITY]        = density;
+      old_variable[VAR_MOMENTUM+0]     = momentum.x;
+      old_variable[VAR_MOMENTUM+1]     = momentum.y;
+      old_variable[VAR_MOMENTUM+2]     = momentum.z;
+      old_variable[VAR_DENSITY_ENERGY] = density_energy;
+
+      double3 velocity; compute_velocity(density, momentum, velocity);
+      double speed_sqd      = compute_speed_sqd(velocity);
+      double pressure       = compute_pressure(density, density_energy, speed_sqd);
+      double speed_of_sound = compute_speed_of_sound(density, pressure);
+
+      double dt = double(0.5) * (cbrt(*volume) / (sqrt(speed_sqd) + speed_of_sound));
+      if (dt < (*min_dt)) {
+          *min_dt = dt;
+      }
+    //end inline func
+  }
+
+  *arg3 = arg3_l;
+}
@@ -0,0 +1,107 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+//user function
+
+void residual_rms_kernel_omp4_kernel(
+  double *data0,
+  int dat0size,
+  double *data1,
+  int dat1size,
+  double *data2,
+  int dat2size,
+  double *arg3,
+  int *arg4,
+  int count,
+  int num_teams,
+  int nthread);
+
+// host stub function
+void op_par_loop_residual_rms_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  double*arg3h = (double *)arg3.data;
+  int*arg4h = (int *)arg4.data;
+  int nargs = 5;
+  op_arg args[5];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+  args[4] = arg4;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(29);
+  op_timers_core(&cpu_t1, &wall_t1);
+  OP_kernels[29].name      = name;
+  OP_kernels[29].count    += 1;
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  residual_rms_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges_cuda(set, nargs, args);
+
+  #ifdef OP_PART_SIZE_29
+    int part_size = OP_PART_SIZE_29;
+  #else
+    int part_size = OP_part_size;
+  #endif
+  #ifdef OP_BLOCK_SIZE_29
+    int nthread = OP_BLOCK_SIZE_29;
+  #else
+    int nthread = OP_block_size;
+  #endif
+
+  double arg3_l = arg3h[0];
+  int arg4_l = arg4h[0];
+
+  if (set_size >0) {
+
+    //Set up typed device pointers for OpenMP
+
+    double* data0 = (double*)arg0.data_d;
+    int dat0size = getSetSizeFromOpArg(&arg0) * arg0.dat->dim;
+    double* data1 = (double*)arg1.data_d;
+    int dat1size = getSetSizeFromOpArg(&arg1) * arg1.dat->dim;
+    double* data2 = (double*)arg2.data_d;
+    int dat2size = getSetSizeFromOpArg(&arg2) * arg2.dat->dim;
+    residual_rms_kernel_omp4_kernel(
+      data0,
+      dat0size,
+      data1,
+      dat1size,
+      data2,
+      dat2size,
+      &arg3_l,
+      &arg4_l,
+      set->size,
+      part_size!=0?(set->size-1)/part_size+1:(set->size-1)/nthread,
+      nthread);
+
+  }
+
+  // combine reduction data
+  arg3h[0] = arg3_l;
+  op_mpi_reduce_double(&arg3,arg3h);
+  arg4h[0] = arg4_l;
+  op_mpi_reduce_int(&arg4,arg4h);
+  op_mpi_set_dirtybit_cuda(nargs, args);
+
+  if (OP_diags>1) deviceSync();
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[29].time     += wall_t2 - wall_t1;
+  OP_kernels[29].transfer += (float)set->size * arg0.size;
+  OP_kernels[29].transfer += (float)set->size * arg1.size;
+  OP_kernels[29].transfer += (float)set->size * arg2.size * 2.0f;
+}
@@ -0,0 +1,53 @@
+//
+// auto-generated by op2.py
+//
+
+#include "utils.h"
+
+void residual_rms_kernel_omp4_kernel(
+  double *data0,
+  int dat0size,
+  double *data1,
+  int dat1size,
+  double *data2,
+  int dat2size,
+  double *arg3,
+  int *arg4,
+  int count,
+  int num_teams,
+  int nthread){
+
+  double arg3_l = *arg3;
+  int arg4_l = *arg4;
+  #pragma omp target teams num_teams(num_teams) thread_limit(nthread) map(to:data0[0:dat0size],data1[0:dat1size],data2[0:dat2size])\
+    map(tofrom: arg3_l, arg4_l) reduction(+:arg3_l) reduction(+:arg4_l)
+  #pragma omp distribute parallel for schedule(static,1) reduction(+:arg3_l) reduction(+:arg4_l)
+  for ( int n_op=0; n_op<count; n_op++ ){
+    //variable mapping
+    const double* old_variable = &data0[5*n_op];
+    const double* variable = &data1[5*n_op];
+    double* residual = &data2[5*n_op];
+    double* rms = &arg3_l;
+    int* count = &arg4_l;
+
+    //inline function
+    
+      for (int v=0; v<NVAR; v++) {
+          residual[v] = variable[v] - old_variable[v];
+          *rms += residual[v]*residual[v];
+      }
+      #ifdef OPENACC
+
+      #else
+          for (int v=0; v<NVAR; v++) {
+              if (isnan(variable[v]) || isinf(variable[v])) {
+                  *count += 1;
+              }
+          }
+      #endif
+    //end inline func
+  }
+
+  *arg3 = arg3_l;
+  *arg4 = arg4_l;
+}
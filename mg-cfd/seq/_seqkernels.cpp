@@ -16,14 +16,19 @@
 #include "copy_double_kernel_seqkernel.cpp"
 #include "calculate_dt_kernel_seqkernel.cpp"
 #include "get_min_dt_kernel_seqkernel.cpp"
+#include "copy_calculate_min_dt_kernel_seqkernel.cpp"
 #include "compute_step_factor_kernel_seqkernel.cpp"
 #include "compute_flux_edge_kernel_seqkernel.cpp"
+#include "compute_node_primitives_kernel_seqkernel.cpp"
+#include "compute_flux_edge_primitives_kernel_seqkernel.cpp"
 #include "compute_bnd_node_flux_kernel_seqkernel.cpp"
 #include "time_step_kernel_seqkernel.cpp"
+#include "time_step_min_dt_kernel_seqkernel.cpp"
 #include "indirect_rw_kernel_seqkernel.cpp"
 #include "residual_kernel_seqkernel.cpp"
 #include "calc_rms_kernel_seqkernel.cpp"
 #include "count_bad_vals_seqkernel.cpp"
+#include "residual_rms_kernel_seqkernel.cpp"
 #include "up_pre_kernel_seqkernel.cpp"
 #include "up_kernel_seqkernel.cpp"
 #include "up_post_kernel_seqkernel.cpp"
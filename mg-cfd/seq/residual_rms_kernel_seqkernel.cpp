@@ -0,0 +1,62 @@
+//
+// auto-generated by op2.py
+//
+
+//user function
+#include ".././src/Kernels/validation.h"
+
+// host stub function
+void op_par_loop_residual_rms_kernel(char const *name, op_set set,
+  op_arg arg0,
+  op_arg arg1,
+  op_arg arg2,
+  op_arg arg3,
+  op_arg arg4){
+
+  int nargs = 5;
+  op_arg args[5];
+
+  args[0] = arg0;
+  args[1] = arg1;
+  args[2] = arg2;
+  args[3] = arg3;
+  args[4] = arg4;
+
+  // initialise timers
+  double cpu_t1, cpu_t2, wall_t1, wall_t2;
+  op_timing_realloc(29);
+  op_timers_core(&cpu_t1, &wall_t1);
+
+
+  if (OP_diags>2) {
+    printf(" kernel routine w/o indirection:  residual_rms_kernel");
+  }
+
+  int set_size = op_mpi_halo_exchanges(set, nargs, args);
+
+  if (set_size > 0) {
+
+    for ( int n=0; n<set_size; n++ ){
+      residual_rms_kernel(
+        &((double*)arg0.data)[5*n],
+        &((double*)arg1.data)[5*n],
+        &((double*)arg2.data)[5*n],
+        (double*)arg3.data,
+        (int*)arg4.data);
+    }
+  }
+
+  // combine reduction data
+  op_mpi_reduce_double(&arg3,(double*)arg3.data);
+  op_mpi_reduce_int(&arg4,(int*)arg4.data);
+  op_mpi_set_dirtybit(nargs, args);
+
+  // update kernel record
+  op_timers_core(&cpu_t2, &wall_t2);
+  OP_kernels[29].name      = name;
+  OP_kernels[29].count    += 1;
+  OP_kernels[29].time     += wall_t2 - wall_t1;
+  OP_kernels[29].transfer += (float)set->size * arg0.size;
+  OP_kernels[29].transfer += (float)set->size * arg1.size;
+  OP_kernels[29].transfer += (float)set->size * arg2.size * 2.0f;
+}
@@ -336,4 +336,158 @@ inline void compute_flux_edge_kernel(
     - factor_z*(flux_contribution_i_momentum_z_a[2] + flux_contribution_i_momentum_z_b[2]);
 }
 
+// Node-wise half of compute_flux_edge_kernel. Each node's velocity,
+// pressure, speed of sound and flux contributions are computed once here
+// rather than once for every edge incident on it, and packed into
+// 'primitives' (see PRIM_* in const.h) for compute_flux_edge_primitives_kernel.
+inline void compute_node_primitives_kernel(
+    const double *variables,
+    double *primitives)
+{
+  double p = variables[VAR_DENSITY];
+
+  #ifdef IDIVIDE
+  double ip = 1.0 / p;
+  #endif
+
+  double pe, pressure;
+  double3 velocity, momentum;
+
+  momentum.x = variables[VAR_MOMENTUM+0];
+  momentum.y = variables[VAR_MOMENTUM+1];
+  momentum.z = variables[VAR_MOMENTUM+2];
+  pe = variables[VAR_DENSITY_ENERGY];
+
+  #ifdef IDIVIDE
+  compute_velocity(ip, momentum, velocity);
+  #else
+  compute_velocity(p, momentum, velocity);
+  #endif
+
+  double speed_sqd = compute_speed_sqd(velocity);
+
+  pressure = compute_pressure(p, pe, speed_sqd);
+
+  primitives[PRIM_DENSITY]        = p;
+  primitives[PRIM_MOMENTUM+0]     = momentum.x;
+  primitives[PRIM_MOMENTUM+1]     = momentum.y;
+  primitives[PRIM_MOMENTUM+2]     = momentum.z;
+  primitives[PRIM_DENSITY_ENERGY] = pe;
+  primitives[PRIM_SPEED]          = std::sqrt(speed_sqd);
+
+  #ifdef IDIVIDE
+  primitives[PRIM_SPEED_OF_SOUND] = compute_speed_of_sound(ip, pressure);
+  #else
+  primitives[PRIM_SPEED_OF_SOUND] = compute_speed_of_sound(p, pressure);
+  #endif
+
+  compute_flux_contribution(p, momentum, pe,
+                            pressure, velocity,
+                            &primitives[PRIM_FLUX_MOMENTUM_X],
+                            &primitives[PRIM_FLUX_MOMENTUM_Y],
+                            &primitives[PRIM_FLUX_MOMENTUM_Z],
+                            &primitives[PRIM_FLUX_DENSITY_ENERGY]);
+}
+
+// Same fluxes as compute_flux_edge_kernel, from the values that
+// compute_node_primitives_kernel stored for the two endpoints.
+inline void compute_flux_edge_primitives_kernel(
+    const double *primitives_a,
+    const double *primitives_b,
+    const double *edge_weight,
+    double *fluxes_a, 
+    double *fluxes_b)
+{
+  double ewt = std::sqrt(edge_weight[0]*edge_weight[0] +
+                         edge_weight[1]*edge_weight[1] +
+                         edge_weight[2]*edge_weight[2]);
+
+  double p_a = primitives_a[PRIM_DENSITY],
+         p_b = primitives_b[PRIM_DENSITY];
+  double pe_a = primitives_a[PRIM_DENSITY_ENERGY],
+         pe_b = primitives_b[PRIM_DENSITY_ENERGY];
+  double3 momentum_a, momentum_b;
+  momentum_a.x = primitives_a[PRIM_MOMENTUM+0];
+  momentum_a.y = primitives_a[PRIM_MOMENTUM+1];
+  momentum_a.z = primitives_a[PRIM_MOMENTUM+2];
+  momentum_b.x = primitives_b[PRIM_MOMENTUM+0];
+  momentum_b.y = primitives_b[PRIM_MOMENTUM+1];
+  momentum_b.z = primitives_b[PRIM_MOMENTUM+2];
+
+  double speed_a = primitives_a[PRIM_SPEED],
+         speed_b = primitives_b[PRIM_SPEED];
+  double speed_of_sound_a = primitives_a[PRIM_SPEED_OF_SOUND],
+         speed_of_sound_b = primitives_b[PRIM_SPEED_OF_SOUND];
+
+  double factor_a = -ewt*smoothing_coefficient*0.5
+                    *(speed_a + speed_b
+                    + speed_of_sound_a + speed_of_sound_b);
+
+  double factor_b = -ewt*smoothing_coefficient*0.5
+                    *(speed_b + speed_a
+                    + speed_of_sound_b + speed_of_sound_a);
+
+  double factor_x = -0.5*edge_weight[0], factor_y = -0.5*edge_weight[1], factor_z = -0.5*edge_weight[2];
+
+  fluxes_a[VAR_DENSITY] += 
+      factor_a*(p_a - p_b)
+    + factor_x*(momentum_a.x + momentum_b.x)
+    + factor_y*(momentum_a.y + momentum_b.y)
+    + factor_z*(momentum_a.z + momentum_b.z);
+
+  fluxes_a[VAR_DENSITY_ENERGY] += 
+      factor_a*(pe_a - pe_b)
+    + factor_x*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+0] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+0])
+    + factor_y*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+1] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+1])
+    + factor_z*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+2] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+2]);
+
+  fluxes_a[VAR_MOMENTUM + 0] += 
+      factor_a*(momentum_a.x - momentum_b.x)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_X+0] + primitives_b[PRIM_FLUX_MOMENTUM_X+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_X+1] + primitives_b[PRIM_FLUX_MOMENTUM_X+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_X+2] + primitives_b[PRIM_FLUX_MOMENTUM_X+2]);
+
+  fluxes_a[VAR_MOMENTUM + 1] += 
+      factor_a*(momentum_a.y - momentum_b.y)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Y+0] + primitives_b[PRIM_FLUX_MOMENTUM_Y+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Y+1] + primitives_b[PRIM_FLUX_MOMENTUM_Y+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Y+2] + primitives_b[PRIM_FLUX_MOMENTUM_Y+2]);
+
+  fluxes_a[VAR_MOMENTUM + 2] += 
+      factor_a*(momentum_a.z - momentum_b.z)
+    + factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Z+0] + primitives_b[PRIM_FLUX_MOMENTUM_Z+0])
+    + factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Z+1] + primitives_b[PRIM_FLUX_MOMENTUM_Z+1])
+    + factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Z+2] + primitives_b[PRIM_FLUX_MOMENTUM_Z+2]);
+
+  fluxes_b[VAR_DENSITY] += 
+      factor_b*(p_b - p_a)
+    - factor_x*(momentum_a.x + momentum_b.x)
+    - factor_y*(momentum_a.y + momentum_b.y)
+    - factor_z*(momentum_a.z + momentum_b.z);
+
+  fluxes_b[VAR_DENSITY_ENERGY] += 
+      factor_b*(pe_b - pe_a)
+    - factor_x*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+0] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+0])
+    - factor_y*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+1] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+1])
+    - factor_z*(primitives_a[PRIM_FLUX_DENSITY_ENERGY+2] + primitives_b[PRIM_FLUX_DENSITY_ENERGY+2]);
+
+  fluxes_b[VAR_MOMENTUM + 0] += 
+      factor_b*(momentum_b.x - momentum_a.x)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_X+0] + primitives_b[PRIM_FLUX_MOMENTUM_X+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_X+1] + primitives_b[PRIM_FLUX_MOMENTUM_X+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_X+2] + primitives_b[PRIM_FLUX_MOMENTUM_X+2]);
+
+  fluxes_b[VAR_MOMENTUM + 1] += 
+      factor_b*(momentum_b.y - momentum_a.y)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Y+0] + primitives_b[PRIM_FLUX_MOMENTUM_Y+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Y+1] + primitives_b[PRIM_FLUX_MOMENTUM_Y+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Y+2] + primitives_b[PRIM_FLUX_MOMENTUM_Y+2]);
+
+  fluxes_b[VAR_MOMENTUM + 2] += 
+      factor_b*(momentum_b.z - momentum_a.z)
+    - factor_x*(primitives_a[PRIM_FLUX_MOMENTUM_Z+0] + primitives_b[PRIM_FLUX_MOMENTUM_Z+0])
+    - factor_y*(primitives_a[PRIM_FLUX_MOMENTUM_Z+1] + primitives_b[PRIM_FLUX_MOMENTUM_Z+1])
+    - factor_z*(primitives_a[PRIM_FLUX_MOMENTUM_Z+2] + primitives_b[PRIM_FLUX_MOMENTUM_Z+2]);
+}
+
 #endif
@@ -40,6 +40,40 @@ inline void get_min_dt_kernel(
     }
 }
 
+// Fuses copy_double_kernel, calculate_dt_kernel and get_min_dt_kernel, so
+// the variables are read once and no per-node dt is stored:
+inline void copy_calculate_min_dt_kernel(
+    const double* variable, 
+    const double* volume, 
+    double* old_variable, 
+    double* min_dt)
+{
+    double density = variable[VAR_DENSITY];
+
+    double3 momentum;
+    momentum.x = variable[VAR_MOMENTUM+0];
+    momentum.y = variable[VAR_MOMENTUM+1];
+    momentum.z = variable[VAR_MOMENTUM+2];
+
+    double density_energy = variable[VAR_DENSITY_ENERGY];
+
+    old_variable[VAR_DENSITY]        = density;
+    old_variable[VAR_MOMENTUM+0]     = momentum.x;
+    old_variable[VAR_MOMENTUM+1]     = momentum.y;
+    old_variable[VAR_MOMENTUM+2]     = momentum.z;
+    old_variable[VAR_DENSITY_ENERGY] = density_energy;
+
+    double3 velocity; compute_velocity(density, momentum, velocity);
+    double speed_sqd      = compute_speed_sqd(velocity);
+    double pressure       = compute_pressure(density, density_energy, speed_sqd);
+    double speed_of_sound = compute_speed_of_sound(density, pressure);
+
+    double dt = double(0.5) * (cbrt(*volume) / (sqrt(speed_sqd) + speed_of_sound));
+    if (dt < (*min_dt)) {
+        *min_dt = dt;
+    }
+}
+
 inline void compute_step_factor_kernel(
     const double* variable, 
     const double* volume, 
@@ -85,4 +119,29 @@ inline void time_step_kernel(
     flux[VAR_DENSITY_ENERGY] = 0.0;
 }
 
+// time_step_kernel with the step factor of compute_step_factor_kernel
+// formed in place, so that pass and the step factors dat can be skipped:
+inline void time_step_min_dt_kernel(
+    const int* rkCycle,
+    const double* min_dt,
+    const double* volume,
+    double* flux,
+    const double* old_variable,
+    double* variable)
+{
+    double factor = ((*min_dt) / (*volume))/double(RK+1-(*rkCycle));
+
+    variable[VAR_DENSITY]        = old_variable[VAR_DENSITY]        + factor*flux[VAR_DENSITY];
+    variable[VAR_MOMENTUM+0]     = old_variable[VAR_MOMENTUM+0]     + factor*flux[VAR_MOMENTUM+0];
+    variable[VAR_MOMENTUM+1]     = old_variable[VAR_MOMENTUM+1]     + factor*flux[VAR_MOMENTUM+1];
+    variable[VAR_MOMENTUM+2]     = old_variable[VAR_MOMENTUM+2]     + factor*flux[VAR_MOMENTUM+2];
+    variable[VAR_DENSITY_ENERGY] = old_variable[VAR_DENSITY_ENERGY] + factor*flux[VAR_DENSITY_ENERGY];
+
+    flux[VAR_DENSITY]        = 0.0;
+    flux[VAR_MOMENTUM+0]     = 0.0;
+    flux[VAR_MOMENTUM+1]     = 0.0;
+    flux[VAR_MOMENTUM+2]     = 0.0;
+    flux[VAR_DENSITY_ENERGY] = 0.0;
+}
+
 #endif
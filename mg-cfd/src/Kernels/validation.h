@@ -114,4 +114,28 @@ inline void count_bad_vals(
     #endif
 }
 
+// Fuses residual_kernel, calc_rms_kernel and count_bad_vals for the
+// finest level, which needs all three:
+inline void residual_rms_kernel(
+    const double* old_variable, 
+    const double* variable, 
+    double* residual, 
+    double* rms, 
+    int* count)
+{
+    for (int v=0; v<NVAR; v++) {
+        residual[v] = variable[v] - old_variable[v];
+        *rms += residual[v]*residual[v];
+    }
+    #ifdef OPENACC
+        // OpenACC compilation is complaining about use of isnan()
+    #else
+        for (int v=0; v<NVAR; v++) {
+            if (isnan(variable[v]) || isinf(variable[v])) {
+                *count += 1;
+            }
+        }
+    #endif
+}
+
 #endif
@@ -82,6 +82,16 @@ typedef struct {
 
     bool validate_result;
 
+    bool flux_precompute;
+    bool fuse_node_kernels;
+
+    bool indirect_rw_benchmark;
+    int indirect_rw_repeats;
+
+    // Bit l set runs level l's RK stages sparse-tiled (openmp builds)
+    int sparse_tiled_levels;
+    int sparse_tile_size;
+
     bool output_volumes;
     bool output_step_factors;
     bool output_edge_mx;
@@ -135,6 +145,15 @@ inline void set_config_defaults() {
 
     conf.validate_result = false;
 
+    conf.flux_precompute = true;
+    conf.fuse_node_kernels = true;
+
+    conf.indirect_rw_benchmark = false;
+    conf.indirect_rw_repeats = 20;
+
+    conf.sparse_tiled_levels = 0;
+    conf.sparse_tile_size = 2048;
+
     conf.num_cycles = 10;
 
     conf.partitioner = Partitioners::Parmetis;
@@ -174,6 +193,45 @@ inline void set_config_param(const char* const key, const char* const value) {
         }
     }
 
+    else if (strcmp(key,"flux_precompute")==0) {
+        if (strcmp(value, "N")==0) {
+            conf.flux_precompute = false;
+        }
+    }
+
+    else if (strcmp(key,"fuse_node_kernels")==0) {
+        if (strcmp(value, "N")==0) {
+            conf.fuse_node_kernels = false;
+        }
+    }
+
+    else if (strcmp(key,"indirect_rw_benchmark")==0) {
+        if (strcmp(value, "Y")==0) {
+            conf.indirect_rw_benchmark = true;
+        }
+    }
+
+    else if (strcmp(key,"indirect_rw_repeats")==0) {
+        conf.indirect_rw_repeats = atoi(value);
+    }
+
+    else if (strcmp(key,"sparse_tiled_levels")==0) {
+        // comma-separated list of levels, or 'all'
+        if (strcmp(value, "all")==0) {
+            conf.sparse_tiled_levels = ~0;
+        } else {
+            std::istringstream levels_iss(value);
+            std::string level;
+            while (std::getline(levels_iss, level, ',')) {
+                conf.sparse_tiled_levels |= 1 << atoi(level.c_str());
+            }
+        }
+    }
+
+    else if (strcmp(key,"sparse_tile_size")==0) {
+        conf.sparse_tile_size = atoi(value);
+    }
+
     else if (strcmp(key, "cycles")==0) {
         conf.num_cycles = atoi(value);
     }
@@ -64,8 +64,17 @@ config conf;
 #include "validation.h"
 #include "indirect_rw.h"
 #include "coupler_config.h"
+#include "input_decks.h"
+
+#ifdef SPARSE_TILING
+// Implemented by the openmp backend, see openmp/sparse_tiled_rk_stage_kernel.cpp
+void op_par_loop_sparse_tiled_rk_stage(char const *, int, bool,
+  op_set, op_arg, op_arg, op_arg, op_arg, op_arg,
+  op_set, op_arg, op_arg, op_arg, op_arg,
+  op_set, op_arg, op_arg, op_arg, op_arg, op_arg, op_arg );
+#endif
 
-int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, struct unit units[], struct locators relative_positions[])
+int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, struct unit units[], struct input_decks *decks)
 {
     #ifdef NANCHECK
         feenableexcept(FE_ALL_EXCEPT & ~FE_INEXACT);
@@ -134,6 +143,16 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
     
     op_printf("MG-CFD Instance %s running!\n", filename);
     op_printf("MG-CFD Instance %s output is saved in file %s\n", filename, default_name);
+
+    #ifdef SPARSE_TILING
+        if (conf.sparse_tiled_levels != 0 && !conf.fuse_node_kernels) {
+            op_printf("WARNING: sparse tiling needs fuse_node_kernels, RK stages will not be tiled\n");
+        }
+    #else
+        if (conf.sparse_tiled_levels != 0) {
+            op_printf("WARNING: sparse tiling is only built into the openmp binaries, RK stages will not be tiled\n");
+        }
+    #endif
     
     // timer
     double cpu_t1, cpu_t2, wall_t1, wall_t2;
@@ -236,6 +255,7 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
            p_step_factors[levels],
            p_fluxes[levels];
     op_dat p_up_scratch[levels];
+    op_dat p_node_primitives[levels];
 
     // Setup OP2
     char* op_name = alloc<char>(100);
@@ -395,6 +415,13 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
             sprintf(op_name, "p_fluxes_L%d", i);
             p_fluxes[i] = op_decl_dat_temp_char(op_nodes[i], NVAR, "double", sizeof(double), op_name);
 
+            if (conf.flux_precompute) {
+                sprintf(op_name, "p_node_primitives_L%d", i);
+                p_node_primitives[i] = op_decl_dat_temp_char(op_nodes[i], NPRIM, "double", sizeof(double), op_name);
+            } else {
+                p_node_primitives[i] = NULL;
+            }
+
             if (i > 0) {
                 sprintf(op_name, "p_up_scratch_L%d", i);
                 p_up_scratch[i] = op_decl_dat_temp_char(op_nodes[i], 1, "int", sizeof(double), op_name);
@@ -453,10 +480,7 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
   
     MPI_Gather(&internal_rank, 1, MPI_INT, ranks, 1, MPI_INT, 0, mgcfd_comm);
 
-    int worldrank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &worldrank); 
- 
-    int mgcfd_unit_num = relative_positions[worldrank].placelocator;
+    int mgcfd_unit_num = instance_number;
     int unit_count = 0;
     int mgcfd_count = 1;//since units start from 1
     bool found = false;
@@ -548,20 +572,7 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
 
                 for(int z = 0; z < total_coupler_unit_count; z++){
                     coupler_rank = units[unit_count].coupler_ranks[z][0];
-					int coupler_position = relative_positions[coupler_rank].placelocator;
-					found = false;
-					int unit_count_2 = 0;
-					int coupler_unit_count = 1;
-					while(!found){//this is used to find out the unit index of the coupler unit we want
-						if(units[unit_count_2].type == 'C' && coupler_unit_count == coupler_position){
-						found=true;
-						}else{
-							if(units[unit_count_2].type == 'C'){
-								coupler_unit_count++;
-							}
-							unit_count_2++;
-						}
-					}
+					int unit_count_2 = units[unit_count].coupler_units[z];//unit index of the coupler unit we want
 					int coupler_vars = 0;
 					if(units[unit_count_2].coupling_type == 'S'){
 						coupler_vars = 5;
@@ -605,30 +616,48 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
         
 
 
-        op_par_loop(copy_double_kernel,"copy_double_kernel",op_nodes[level],
-                    op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_WRITE));
-
-        // for the first iteration we compute the time step
-        op_par_loop(calculate_dt_kernel,"calculate_dt_kernel",op_nodes[level],
-                    op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
-                    op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_WRITE));
         min_dt = std::numeric_limits<double>::max();
-        op_par_loop(get_min_dt_kernel,"get_min_dt_kernel",op_nodes[level],
-                    op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_READ),
-                    op_arg_gbl(&min_dt,1,"double",OP_MIN));
+        if (conf.fuse_node_kernels) {
+            // save the variables and find the time step in one pass
+            op_par_loop(copy_calculate_min_dt_kernel,"copy_calculate_min_dt_kernel",op_nodes[level],
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_WRITE),
+                        op_arg_gbl(&min_dt,1,"double",OP_MIN));
+        } else {
+            op_par_loop(copy_double_kernel,"copy_double_kernel",op_nodes[level],
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_WRITE));
+
+            // for the first iteration we compute the time step
+            op_par_loop(calculate_dt_kernel,"calculate_dt_kernel",op_nodes[level],
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                        op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_WRITE));
+            op_par_loop(get_min_dt_kernel,"get_min_dt_kernel",op_nodes[level],
+                        op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_READ),
+                        op_arg_gbl(&min_dt,1,"double",OP_MIN));
+        }
         if (min_dt < 0.0f) {
           sprintf(buffer,"Fatal error during 'step factor' calculation, min_dt = %.5e\n", min_dt);
           op_print_file(buffer, fp);
           op_exit();
           return 1;
         }
-        op_par_loop(compute_step_factor_kernel,"compute_step_factor_kernel",op_nodes[level],
-                    op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
-                    op_arg_gbl(&min_dt,1,"double",OP_READ),
-                    op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_WRITE));
+        // time_step_min_dt_kernel forms the step factors itself, so they are
+        // only stored when they are output
+        if (!conf.fuse_node_kernels || conf.output_step_factors) {
+            op_par_loop(compute_step_factor_kernel,"compute_step_factor_kernel",op_nodes[level],
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                        op_arg_gbl(&min_dt,1,"double",OP_READ),
+                        op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_WRITE));
+        }
+
+        #ifdef SPARSE_TILING
+            // the tiled chain ends with the fused node update
+            bool tile_rk_stages = conf.fuse_node_kernels && ((conf.sparse_tiled_levels >> level) & 1);
+        #endif
 
         int rkCycle;
         for (rkCycle=0; rkCycle<RK; rkCycle++)
@@ -638,12 +667,54 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
                 op_print_file(buffer, fp);
             #endif
 
-            op_par_loop(compute_flux_edge_kernel,"compute_flux_edge_kernel",op_edges[level],
-                        op_arg_dat(p_variables[level],0,p_edge_to_nodes[level],5,"double",OP_READ),
-                        op_arg_dat(p_variables[level],1,p_edge_to_nodes[level],5,"double",OP_READ),
-                        op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
-                        op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
-                        op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC));
+            if (conf.flux_precompute) {
+                op_par_loop(compute_node_primitives_kernel,"compute_node_primitives_kernel",op_nodes[level],
+                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_node_primitives[level],-1,OP_ID,19,"double",OP_WRITE));
+            }
+
+            #ifdef SPARSE_TILING
+            if (tile_rk_stages) {
+                op_dat flux_input = conf.flux_precompute ? p_node_primitives[level] : p_variables[level];
+                int flux_input_dim = conf.flux_precompute ? NPRIM : NVAR;
+                op_par_loop_sparse_tiled_rk_stage("sparse_tiled_rk_stage", conf.sparse_tile_size, conf.flux_precompute,
+                            op_edges[level],
+                            op_arg_dat(flux_input,0,p_edge_to_nodes[level],flux_input_dim,"double",OP_READ),
+                            op_arg_dat(flux_input,1,p_edge_to_nodes[level],flux_input_dim,"double",OP_READ),
+                            op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
+                            op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC),
+                            op_bnd_nodes[level],
+                            op_arg_dat(p_bnd_node_groups[level],-1,OP_ID,1,"int",OP_READ),
+                            op_arg_dat(p_bnd_node_weights[level],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_variables[level],0,p_bnd_node_to_node[level],5,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],0,p_bnd_node_to_node[level],5,"double",OP_INC),
+                            op_nodes[level],
+                            op_arg_gbl(&rkCycle,1,"int",OP_READ),
+                            op_arg_gbl(&min_dt,1,"double",OP_READ),
+                            op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_INC),
+                            op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_WRITE));
+                continue;
+            }
+            #endif
+
+            if (conf.flux_precompute) {
+                op_par_loop(compute_flux_edge_primitives_kernel,"compute_flux_edge_primitives_kernel",op_edges[level],
+                            op_arg_dat(p_node_primitives[level],0,p_edge_to_nodes[level],19,"double",OP_READ),
+                            op_arg_dat(p_node_primitives[level],1,p_edge_to_nodes[level],19,"double",OP_READ),
+                            op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
+                            op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC));
+            } else {
+                op_par_loop(compute_flux_edge_kernel,"compute_flux_edge_kernel",op_edges[level],
+                            op_arg_dat(p_variables[level],0,p_edge_to_nodes[level],5,"double",OP_READ),
+                            op_arg_dat(p_variables[level],1,p_edge_to_nodes[level],5,"double",OP_READ),
+                            op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
+                            op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC));
+            }
 
             op_par_loop(compute_bnd_node_flux_kernel,"compute_bnd_node_flux_kernel",op_bnd_nodes[level],
                         op_arg_dat(p_bnd_node_groups[level],-1,OP_ID,1,"int",OP_READ),
@@ -651,43 +722,58 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
                         op_arg_dat(p_variables[level],0,p_bnd_node_to_node[level],5,"double",OP_READ),
                         op_arg_dat(p_fluxes[level],0,p_bnd_node_to_node[level],5,"double",OP_INC));
 
-            op_par_loop(time_step_kernel,"time_step_kernel",op_nodes[level],
-                        op_arg_gbl(&rkCycle,1,"int",OP_READ),
-                        op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_READ),
-                        op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_INC),
-                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
-                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_WRITE));
-
-            op_par_loop(indirect_rw_kernel,"indirect_rw_kernel",op_edges[level],
-                        op_arg_dat(p_variables[level],0,p_edge_to_nodes[level],5,"double",OP_READ),
-                        op_arg_dat(p_variables[level],1,p_edge_to_nodes[level],5,"double",OP_READ),
-                        op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
-                        op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
-                        op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC));
-            op_par_loop(zero_5d_array_kernel,"zero_5d_array_kernel",op_nodes[level],
-                        op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_WRITE));
+            if (conf.fuse_node_kernels) {
+                op_par_loop(time_step_min_dt_kernel,"time_step_min_dt_kernel",op_nodes[level],
+                            op_arg_gbl(&rkCycle,1,"int",OP_READ),
+                            op_arg_gbl(&min_dt,1,"double",OP_READ),
+                            op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_INC),
+                            op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_WRITE));
+            } else {
+                op_par_loop(time_step_kernel,"time_step_kernel",op_nodes[level],
+                            op_arg_gbl(&rkCycle,1,"int",OP_READ),
+                            op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_INC),
+                            op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_WRITE));
+            }
         }
 
-        op_par_loop(residual_kernel,"residual_kernel",op_nodes[level],
-                    op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_WRITE));
-        if (level == 0) {
+        if (conf.fuse_node_kernels && level == 0) {
             rms = 0.0;
-            op_par_loop(calc_rms_kernel,"calc_rms_kernel",op_nodes[level],
-                        op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_READ),
-                        op_arg_gbl(&rms,1,"double",OP_INC));
+            op_par_loop(residual_rms_kernel,"residual_rms_kernel",op_nodes[level],
+                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_WRITE),
+                        op_arg_gbl(&rms,1,"double",OP_INC),
+                        op_arg_gbl(&bad_val_count,1,"int",OP_INC));
+        } else {
+            op_par_loop(residual_kernel,"residual_kernel",op_nodes[level],
+                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_WRITE));
+        }
+        if (level == 0) {
+            if (!conf.fuse_node_kernels) {
+                rms = 0.0;
+                op_par_loop(calc_rms_kernel,"calc_rms_kernel",op_nodes[level],
+                            op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_gbl(&rms,1,"double",OP_INC));
+            }
             rms = sqrt(rms / double(op_get_size(op_nodes[level])));
             // op_printf(" (RMS = %.3e)", rms);
             // Until I get the HDF5 meshes working correctly, no point displaying incorrect RMS.
 
-            #ifdef OPENACC
-              // count_bad_vals() invokes isnan(), unsupported with OpenACC.
-            #else
-                op_par_loop(count_bad_vals,"count_bad_vals",op_nodes[level],
-                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                            op_arg_gbl(&bad_val_count,1,"int",OP_INC));
-            #endif
+            if (!conf.fuse_node_kernels) {
+                #ifdef OPENACC
+                  // count_bad_vals() invokes isnan(), unsupported with OpenACC.
+                #else
+                    op_par_loop(count_bad_vals,"count_bad_vals",op_nodes[level],
+                                op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                                op_arg_gbl(&bad_val_count,1,"int",OP_INC));
+                #endif
+            }
             if (bad_val_count > 0) {
                 op_print_file("Bad variable values detected, aborting\n", fp);
                 op_exit();
@@ -791,6 +877,71 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
 
     op_timings_to_csv(csv_out_filepath.c_str());
 
+    if (conf.indirect_rw_benchmark) {
+        // indirect_rw_kernel moves the same data as compute_flux_edge_kernel
+        // with almost no arithmetic, so comparing the two shows how close the
+        // flux loop gets to the bandwidth bound of its gathers and scatters.
+        // It runs after the OP2 timings are reported, so as not to add to them
+        op_print_file("-----------------------------------------------------\n", fp);
+        sprintf(buffer,"Indirect R/W benchmark, %d repeats of each edge loop:\n", conf.indirect_rw_repeats);
+        op_print_file(buffer, fp);
+        for (int l=0; l<levels; l++) {
+            double bench_cpu, bench_t1, bench_t2, flux_time, rw_time;
+            double edges = double(op_get_size(op_edges[l])) * conf.indirect_rw_repeats;
+            int gathered = conf.flux_precompute ? NPRIM : NVAR;
+
+            if (conf.flux_precompute) {
+                op_par_loop(compute_node_primitives_kernel,"compute_node_primitives_kernel",op_nodes[l],
+                            op_arg_dat(p_variables[l],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_node_primitives[l],-1,OP_ID,19,"double",OP_WRITE));
+            }
+            op_timers(&bench_cpu, &bench_t1);
+            for (int r=0; r<conf.indirect_rw_repeats; r++) {
+                if (conf.flux_precompute) {
+                    op_par_loop(compute_flux_edge_primitives_kernel,"compute_flux_edge_primitives_kernel",op_edges[l],
+                                op_arg_dat(p_node_primitives[l],0,p_edge_to_nodes[l],19,"double",OP_READ),
+                                op_arg_dat(p_node_primitives[l],1,p_edge_to_nodes[l],19,"double",OP_READ),
+                                op_arg_dat(p_edge_weights[l],-1,OP_ID,3,"double",OP_READ),
+                                op_arg_dat(p_fluxes[l],0,p_edge_to_nodes[l],5,"double",OP_INC),
+                                op_arg_dat(p_fluxes[l],1,p_edge_to_nodes[l],5,"double",OP_INC));
+                } else {
+                    op_par_loop(compute_flux_edge_kernel,"compute_flux_edge_kernel",op_edges[l],
+                                op_arg_dat(p_variables[l],0,p_edge_to_nodes[l],5,"double",OP_READ),
+                                op_arg_dat(p_variables[l],1,p_edge_to_nodes[l],5,"double",OP_READ),
+                                op_arg_dat(p_edge_weights[l],-1,OP_ID,3,"double",OP_READ),
+                                op_arg_dat(p_fluxes[l],0,p_edge_to_nodes[l],5,"double",OP_INC),
+                                op_arg_dat(p_fluxes[l],1,p_edge_to_nodes[l],5,"double",OP_INC));
+                }
+            }
+            op_timers(&bench_cpu, &bench_t2);
+            flux_time = bench_t2 - bench_t1;
+
+            op_timers(&bench_cpu, &bench_t1);
+            for (int r=0; r<conf.indirect_rw_repeats; r++) {
+                op_par_loop(indirect_rw_kernel,"indirect_rw_kernel",op_edges[l],
+                            op_arg_dat(p_variables[l],0,p_edge_to_nodes[l],5,"double",OP_READ),
+                            op_arg_dat(p_variables[l],1,p_edge_to_nodes[l],5,"double",OP_READ),
+                            op_arg_dat(p_edge_weights[l],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_fluxes[l],0,p_edge_to_nodes[l],5,"double",OP_INC),
+                            op_arg_dat(p_fluxes[l],1,p_edge_to_nodes[l],5,"double",OP_INC));
+            }
+            op_timers(&bench_cpu, &bench_t2);
+            rw_time = bench_t2 - bench_t1;
+
+            // the time step leaves the fluxes zeroed, so put them back for any output
+            op_par_loop(zero_5d_array_kernel,"zero_5d_array_kernel",op_nodes[l],
+                        op_arg_dat(p_fluxes[l],-1,OP_ID,5,"double",OP_WRITE));
+
+            // per edge: two gathered nodes, the edge weight and two flux increments read and written
+            double flux_bytes = edges * (2*gathered + 3 + 2*2*NVAR) * sizeof(double);
+            double rw_bytes   = edges * (2*NVAR + 3 + 2*2*NVAR) * sizeof(double);
+            sprintf(buffer,"  MG level %d: %s %.3f s, %.2f GB/s; indirect_rw_kernel %.3f s, %.2f GB/s\n", l,
+                    conf.flux_precompute ? "compute_flux_edge_primitives_kernel" : "compute_flux_edge_kernel",
+                    flux_time, flux_bytes / flux_time * 1.0e-9, rw_time, rw_bytes / rw_time * 1.0e-9);
+            op_print_file(buffer, fp);
+        }
+    }
+
     if (conf.validate_result) {
         op_print_file("-----------------------------------------------------\n", fp);
 
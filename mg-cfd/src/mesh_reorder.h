@@ -0,0 +1,262 @@
+#ifndef MESH_REORDER_H
+#define MESH_REORDER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+// Orderings used by mgcfd_reorder to improve the cache locality of the
+// indirect loops. Each ordering returns 'order', the old index of every
+// element in its new position, and permutation() inverts that into the
+// new index of every old element, which is what maps are rewritten with.
+
+namespace MeshOrderings {
+    enum MeshOrderings { RCM, Hilbert, Morton };
+}
+
+inline std::vector<int> permutation(const std::vector<int> &order)
+{
+    std::vector<int> new_index(order.size());
+    for (int i=0; i<(int)order.size(); i++) {
+        new_index[order[i]] = i;
+    }
+    return new_index;
+}
+
+// Reverse Cuthill-McKee over the node graph of edge-->node (0-based). Each
+// connected component starts from a pseudo-peripheral node of least degree.
+inline std::vector<int> rcm_order(int num_nodes, int num_edges, const int* edge_to_nodes)
+{
+    std::vector<int> offsets(num_nodes+1, 0);
+    for (int e=0; e<num_edges; e++) {
+        offsets[edge_to_nodes[2*e]+1]++;
+        offsets[edge_to_nodes[2*e+1]+1]++;
+    }
+    for (int n=0; n<num_nodes; n++) {
+        offsets[n+1] += offsets[n];
+    }
+    std::vector<int> neighbours(offsets[num_nodes]);
+    std::vector<int> fill(offsets.begin(), offsets.end()-1);
+    for (int e=0; e<num_edges; e++) {
+        int a = edge_to_nodes[2*e], b = edge_to_nodes[2*e+1];
+        neighbours[fill[a]++] = b;
+        neighbours[fill[b]++] = a;
+    }
+
+    std::vector<int> order;
+    order.reserve(num_nodes);
+    std::vector<int> level(num_nodes, -1);
+    std::vector<bool> placed(num_nodes, false);
+    std::vector<int> by_degree(num_nodes);
+    for (int n=0; n<num_nodes; n++) {
+        by_degree[n] = n;
+    }
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&](int a, int b) {
+        return offsets[a+1]-offsets[a] < offsets[b+1]-offsets[b];
+    });
+
+    std::vector<int> queue;
+    queue.reserve(num_nodes);
+    for (int seed : by_degree) {
+        if (placed[seed]) {
+            continue;
+        }
+
+        // A few BFS sweeps move the start to the far end of the component,
+        // which keeps the level sets, and so the bandwidth, narrow
+        int start = seed;
+        int depth = -1;
+        for (int sweep=0; sweep<4; sweep++) {
+            queue.assign(1, start);
+            level[start] = sweep*num_nodes;
+            int last = start;
+            for (size_t q=0; q<queue.size(); q++) {
+                int n = queue[q];
+                last = n;
+                for (int k=offsets[n]; k<offsets[n+1]; k++) {
+                    int m = neighbours[k];
+                    if (level[m] < sweep*num_nodes && !placed[m]) {
+                        level[m] = level[n]+1;
+                        queue.push_back(m);
+                    }
+                }
+            }
+            int reached = level[last] - sweep*num_nodes;
+            if (reached <= depth) {
+                break;
+            }
+            depth = reached;
+            // of the deepest level, prefer the node of least degree
+            for (size_t q=queue.size(); q-- > 0 && level[queue[q]] == level[last]; ) {
+                int n = queue[q];
+                if (offsets[n+1]-offsets[n] < offsets[last+1]-offsets[last]) {
+                    last = n;
+                }
+            }
+            start = last;
+        }
+
+        size_t first = order.size();
+        order.push_back(start);
+        placed[start] = true;
+        std::vector<int> next;
+        for (size_t q=first; q<order.size(); q++) {
+            int n = order[q];
+            next.clear();
+            for (int k=offsets[n]; k<offsets[n+1]; k++) {
+                int m = neighbours[k];
+                if (!placed[m]) {
+                    placed[m] = true;
+                    next.push_back(m);
+                }
+            }
+            std::stable_sort(next.begin(), next.end(), [&](int a, int b) {
+                return offsets[a+1]-offsets[a] < offsets[b+1]-offsets[b];
+            });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Quantises a coordinate to 21 bits within the bounding box, so three of
+// them fit one 64-bit key
+inline uint32_t quantise_coordinate(double x, double lo, double hi)
+{
+    if (hi <= lo) {
+        return 0;
+    }
+    double scaled = (x - lo) / (hi - lo) * double((1u << 21) - 1);
+    return (uint32_t)(scaled < 0.0 ? 0.0 : scaled);
+}
+
+// Interleaves the bits of x, y and z, most significant first
+inline uint64_t interleave_bits(const uint32_t* xyz)
+{
+    uint64_t key = 0;
+    for (int b=20; b>=0; b--) {
+        for (int d=0; d<3; d++) {
+            key = (key << 1) | ((xyz[d] >> b) & 1);
+        }
+    }
+    return key;
+}
+
+inline uint64_t morton_key(uint32_t* xyz)
+{
+    return interleave_bits(xyz);
+}
+
+// Skilling's transform of the coordinates into the transposed Hilbert
+// index, which interleaves into the Hilbert key
+inline uint64_t hilbert_key(uint32_t* xyz)
+{
+    const uint32_t top = 1u << 20;
+    for (uint32_t q=top; q>1; q>>=1) {
+        uint32_t p = q - 1;
+        for (int d=0; d<3; d++) {
+            if (xyz[d] & q) {
+                xyz[0] ^= p;
+            } else {
+                uint32_t t = (xyz[0] ^ xyz[d]) & p;
+                xyz[0] ^= t;
+                xyz[d] ^= t;
+            }
+        }
+    }
+    for (int d=1; d<3; d++) {
+        xyz[d] ^= xyz[d-1];
+    }
+    uint32_t t = 0;
+    for (uint32_t q=top; q>1; q>>=1) {
+        if (xyz[2] & q) {
+            t ^= q - 1;
+        }
+    }
+    for (int d=0; d<3; d++) {
+        xyz[d] ^= t;
+    }
+    return interleave_bits(xyz);
+}
+
+// Sorts nodes along a space-filling curve through their coordinates
+inline std::vector<int> curve_order(int num_nodes, const double* coords, MeshOrderings::MeshOrderings ordering)
+{
+    double lo[3], hi[3];
+    for (int d=0; d<3; d++) {
+        lo[d] = hi[d] = (num_nodes > 0) ? coords[d] : 0.0;
+    }
+    for (int n=0; n<num_nodes; n++) {
+        for (int d=0; d<3; d++) {
+            lo[d] = std::min(lo[d], coords[3*n+d]);
+            hi[d] = std::max(hi[d], coords[3*n+d]);
+        }
+    }
+
+    std::vector<uint64_t> keys(num_nodes);
+    for (int n=0; n<num_nodes; n++) {
+        uint32_t xyz[3];
+        for (int d=0; d<3; d++) {
+            xyz[d] = quantise_coordinate(coords[3*n+d], lo[d], hi[d]);
+        }
+        keys[n] = (ordering == MeshOrderings::Hilbert) ? hilbert_key(xyz) : morton_key(xyz);
+    }
+
+    std::vector<int> order(num_nodes);
+    for (int n=0; n<num_nodes; n++) {
+        order[n] = n;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return keys[a] < keys[b];
+    });
+    return order;
+}
+
+// Edges sorted by their lower, then higher, new node index. Endpoints keep
+// their order within an edge, as the edge weights are oriented by it.
+inline std::vector<int> edge_order(int num_edges, const int* edge_to_nodes, const std::vector<int> &new_node_index)
+{
+    std::vector<uint64_t> keys(num_edges);
+    for (int e=0; e<num_edges; e++) {
+        uint64_t a = new_node_index[edge_to_nodes[2*e]];
+        uint64_t b = new_node_index[edge_to_nodes[2*e+1]];
+        keys[e] = (std::min(a, b) << 32) | std::max(a, b);
+    }
+    std::vector<int> order(num_edges);
+    for (int e=0; e<num_edges; e++) {
+        order[e] = e;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return keys[a] < keys[b];
+    });
+    return order;
+}
+
+// Boundary nodes sorted by the new index of the node they attach to
+inline std::vector<int> bnd_node_order(int num_bnd_nodes, const int* bnd_node_to_node, const std::vector<int> &new_node_index)
+{
+    std::vector<int> order(num_bnd_nodes);
+    for (int b=0; b<num_bnd_nodes; b++) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return new_node_index[bnd_node_to_node[a]] < new_node_index[bnd_node_to_node[b]];
+    });
+    return order;
+}
+
+// Mean distance between the indices an edge connects, a proxy for how far
+// apart its gathers land in memory
+inline double mean_edge_span(int num_edges, const int* edge_to_nodes)
+{
+    double span = 0.0;
+    for (int e=0; e<num_edges; e++) {
+        span += std::abs(edge_to_nodes[2*e] - edge_to_nodes[2*e+1]);
+    }
+    return (num_edges > 0) ? span / num_edges : 0.0;
+}
+
+#endif
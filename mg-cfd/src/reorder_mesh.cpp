@@ -0,0 +1,336 @@
+// Offline reordering of MG-CFD HDF5 decks for cache locality.
+//
+// Renumbers the nodes of every multigrid level, by reverse Cuthill-McKee
+// over the edge graph or along a Hilbert/Morton curve through
+// node_coordinates, then sorts edges and boundary nodes by the nodes they
+// touch. edge-->node, bnd_node-->node and node-->mg_node are rewritten to
+// match, and the deck is written as a copy so the original is untouched.
+
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <getopt.h>
+#include <sys/stat.h>
+#include "hdf5.h"
+
+#include "op_lib_cpp.h"
+
+#include "const.h"
+#include "structures.h"
+#include "inlined_funcs.h"
+#include "config.h"
+#include "utils.h"
+#include "io.h"
+#include "mesh_reorder.h"
+
+int mesh_name;
+
+static struct option reorder_long_opts[] =
+{
+    { "help",            no_argument,       NULL, 'h' },
+    { "input-file",      required_argument, NULL, 'i' },
+    { "input-directory", required_argument, NULL, 'd' },
+    { "output-directory",required_argument, NULL, 'o' },
+    { "ordering",        required_argument, NULL, 's' },
+    { 0, 0, 0, 0 }
+};
+#define REORDER_GETOPTS "hi:d:o:s:"
+
+inline void print_reorder_help(void)
+{
+    fprintf(stderr, "MG-CFD mesh reordering\n\n");
+    fprintf(stderr, "Usage: mgcfd_reorder [OPTIONS] -i input.dat -o DIRPATH\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "-h, --help    Print help\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "-i, --input-file=FILEPATH\n");
+    fprintf(stderr, "        multigrid input grid (.dat file)\n");
+    fprintf(stderr, "-d, --input-directory=DIRPATH\n");
+    fprintf(stderr, "        directory path to input files\n");
+    fprintf(stderr, "-o, --output-directory=DIRPATH\n");
+    fprintf(stderr, "        directory to write the reordered deck to\n");
+    fprintf(stderr, "-s, --ordering=STRING\n");
+    fprintf(stderr, "        node ordering:\n");
+    fprintf(stderr, "          rcm (default)\n");
+    fprintf(stderr, "          hilbert\n");
+    fprintf(stderr, "          morton\n");
+}
+
+// Creates every directory along 'path'
+inline void make_directories(const std::string &path)
+{
+    for (size_t p=path.find('/', 1); ; p=path.find('/', p+1)) {
+        mkdir(path.substr(0, p).c_str(), 0755);
+        if (p == std::string::npos) {
+            break;
+        }
+    }
+}
+
+inline void copy_file(const std::string &from, const std::string &to)
+{
+    std::ifstream src(from.c_str(), std::ios::binary);
+    if (!src.is_open()) {
+        fprintf(stderr, "Error: Could not open '%s'\n", from.c_str());
+        DEBUGGABLE_ABORT
+    }
+    size_t slash = to.rfind('/');
+    if (slash != std::string::npos) {
+        make_directories(to.substr(0, slash));
+    }
+    std::ofstream dst(to.c_str(), std::ios::binary);
+    dst << src.rdbuf();
+    if (!dst.good()) {
+        fprintf(stderr, "Error: Could not write '%s'\n", to.c_str());
+        DEBUGGABLE_ABORT
+    }
+}
+
+// A dataset held as raw rows in its own native type, so it can be
+// permuted without knowing what it stores
+struct dataset_rows {
+    hid_t type;
+    size_t rows;
+    size_t row_bytes;
+    std::vector<char> data;
+};
+
+inline bool read_rows(hid_t file, const char* name, dataset_rows* d)
+{
+    if (H5Lexists(file, name, H5P_DEFAULT) <= 0) {
+        return false;
+    }
+    hid_t dset = H5Dopen(file, name, H5P_DEFAULT);
+    hid_t space = H5Dget_space(dset);
+    hsize_t dims[H5S_MAX_RANK];
+    H5Sget_simple_extent_dims(space, dims, NULL);
+    hssize_t points = H5Sget_simple_extent_npoints(space);
+    hid_t file_type = H5Dget_type(dset);
+    d->type = H5Tget_native_type(file_type, H5T_DIR_ASCEND);
+    d->rows = dims[0];
+    d->row_bytes = (d->rows > 0) ? (points / d->rows) * H5Tget_size(d->type) : 0;
+    d->data.resize(d->rows * d->row_bytes);
+    if (d->rows > 0) {
+        H5Dread(dset, d->type, H5S_ALL, H5S_ALL, H5P_DEFAULT, d->data.data());
+    }
+    H5Tclose(file_type);
+    H5Sclose(space);
+    H5Dclose(dset);
+    return true;
+}
+
+inline void write_rows(hid_t file, const char* name, dataset_rows* d)
+{
+    hid_t dset = H5Dopen(file, name, H5P_DEFAULT);
+    if (d->rows > 0) {
+        H5Dwrite(dset, d->type, H5S_ALL, H5S_ALL, H5P_DEFAULT, d->data.data());
+    }
+    H5Dclose(dset);
+    H5Tclose(d->type);
+}
+
+inline void permute_rows(dataset_rows* d, const std::vector<int> &order)
+{
+    if (order.size() != d->rows) {
+        fprintf(stderr, "Error: Dataset has %zu rows but its set has %zu elements\n", d->rows, order.size());
+        DEBUGGABLE_ABORT
+    }
+    std::vector<char> permuted(d->data.size());
+    for (size_t i=0; i<order.size(); i++) {
+        memcpy(&permuted[i*d->row_bytes], &d->data[order[i]*d->row_bytes], d->row_bytes);
+    }
+    d->data.swap(permuted);
+}
+
+// Reads a map as 0-based ints, whatever its stored type and base index
+inline std::vector<int> read_map(hid_t file, const char* name, int base_array_index)
+{
+    std::vector<int> map;
+    if (H5Lexists(file, name, H5P_DEFAULT) <= 0) {
+        return map;
+    }
+    hid_t dset = H5Dopen(file, name, H5P_DEFAULT);
+    hid_t space = H5Dget_space(dset);
+    map.resize(H5Sget_simple_extent_npoints(space));
+    if (!map.empty()) {
+        H5Dread(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, map.data());
+    }
+    H5Sclose(space);
+    H5Dclose(dset);
+    for (size_t i=0; i<map.size(); i++) {
+        map[i] -= base_array_index;
+    }
+    return map;
+}
+
+// Renumbers and permutes a map, and writes it back with its
+// original base index
+inline void write_map(
+    hid_t file,
+    const char* name,
+    int base_array_index,
+    const std::vector<int> &map,
+    int dim,
+    const std::vector<int> &order,
+    const std::vector<int> &new_target_index)
+{
+    if (map.empty()) {
+        return;
+    }
+    std::vector<int> rewritten(map.size());
+    for (size_t i=0; i<order.size(); i++) {
+        for (int j=0; j<dim; j++) {
+            rewritten[i*dim+j] = new_target_index[map[order[i]*dim+j]] + base_array_index;
+        }
+    }
+    hid_t dset = H5Dopen(file, name, H5P_DEFAULT);
+    H5Dwrite(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rewritten.data());
+    H5Dclose(dset);
+}
+
+inline void permute_dataset(hid_t file, const char* name, const std::vector<int> &order)
+{
+    dataset_rows d;
+    if (!read_rows(file, name, &d)) {
+        printf("  '%s' not present, skipping\n", name);
+        return;
+    }
+    permute_rows(&d, order);
+    write_rows(file, name, &d);
+}
+
+int main(int argc, char** argv)
+{
+    std::string input_file, input_directory, output_directory;
+    MeshOrderings::MeshOrderings ordering = MeshOrderings::RCM;
+
+    int optc;
+    while ((optc = getopt_long(argc, argv, REORDER_GETOPTS, reorder_long_opts, NULL)) != -1) {
+        switch (optc) {
+            case 'h':
+                print_reorder_help();
+                return 0;
+            case 'i':
+                input_file = optarg;
+                break;
+            case 'd':
+                input_directory = optarg;
+                break;
+            case 'o':
+                output_directory = optarg;
+                break;
+            case 's':
+                if (strcmp(optarg, "rcm")==0) {
+                    ordering = MeshOrderings::RCM;
+                } else if (strcmp(optarg, "hilbert")==0) {
+                    ordering = MeshOrderings::Hilbert;
+                } else if (strcmp(optarg, "morton")==0) {
+                    ordering = MeshOrderings::Morton;
+                } else {
+                    fprintf(stderr, "ERROR: Unknown ordering '%s'\n", optarg);
+                    print_reorder_help();
+                    return 1;
+                }
+                break;
+            default:
+                print_reorder_help();
+                return 1;
+        }
+    }
+    if (input_file == "" || output_directory == "") {
+        print_reorder_help();
+        return 1;
+    }
+
+    std::string input_prefix = (input_directory == "") ? "" : input_directory + "/";
+    std::string output_prefix = output_directory + "/";
+
+    int problem_size = 0;
+    int levels = 0;
+    int base_array_index = 1;
+    std::string* layers = NULL;
+    std::string* mg_connectivity_filename = NULL;
+    read_input_dat((input_prefix + input_file).c_str(), &problem_size, &levels, &base_array_index, &layers, &mg_connectivity_filename);
+
+    // Every level's node numbering has to be known before any file is
+    // written, as node-->mg_node points into the next level
+    std::vector<std::vector<int> > node_order(levels), new_node_index(levels);
+    for (int i=0; i<levels; i++) {
+        std::string path = input_prefix + layers[i];
+        hid_t file = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        if (file < 0) {
+            fprintf(stderr, "Error: Could not open '%s'\n", path.c_str());
+            DEBUGGABLE_ABORT
+        }
+        dataset_rows coords;
+        if (!read_rows(file, "node_coordinates", &coords)) {
+            fprintf(stderr, "Error: '%s' has no node_coordinates; legacy decks are not supported\n", path.c_str());
+            DEBUGGABLE_ABORT
+        }
+        H5Tclose(coords.type);
+        int num_nodes = coords.rows;
+        std::vector<int> edges = read_map(file, "edge-->node", base_array_index);
+
+        if (ordering == MeshOrderings::RCM) {
+            node_order[i] = rcm_order(num_nodes, edges.size()/2, edges.data());
+        } else {
+            std::vector<double> xyz(num_nodes*NDIM);
+            hid_t dset = H5Dopen(file, "node_coordinates", H5P_DEFAULT);
+            H5Dread(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, xyz.data());
+            H5Dclose(dset);
+            node_order[i] = curve_order(num_nodes, xyz.data(), ordering);
+        }
+        new_node_index[i] = permutation(node_order[i]);
+        H5Fclose(file);
+    }
+
+    for (int i=0; i<levels; i++) {
+        std::string in_path = input_prefix + layers[i];
+        std::string out_path = output_prefix + layers[i];
+        printf("Reordering level %d / %d: '%s' -> '%s'\n", i+1, levels, in_path.c_str(), out_path.c_str());
+        copy_file(in_path, out_path);
+        hid_t file = H5Fopen(out_path.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+
+        const std::vector<int> &nodes = node_order[i];
+        const std::vector<int> &new_nodes = new_node_index[i];
+
+        permute_dataset(file, "node_coordinates", nodes);
+
+        std::vector<int> edges = read_map(file, "edge-->node", base_array_index);
+        int num_edges = edges.size()/2;
+        double span_before = mean_edge_span(num_edges, edges.data());
+        std::vector<int> edges_order = edge_order(num_edges, edges.data(), new_nodes);
+        write_map(file, "edge-->node", base_array_index, edges, 2, edges_order, new_nodes);
+        permute_dataset(file, "edge_weights", edges_order);
+        std::vector<int> edges_after = read_map(file, "edge-->node", base_array_index);
+        printf("  mean edge span: %.1f -> %.1f\n", span_before, mean_edge_span(num_edges, edges_after.data()));
+
+        std::vector<int> bnd_nodes = read_map(file, "bnd_node-->node", base_array_index);
+        std::vector<int> bnd_order = bnd_node_order(bnd_nodes.size(), bnd_nodes.data(), new_nodes);
+        write_map(file, "bnd_node-->node", base_array_index, bnd_nodes, 1, bnd_order, new_nodes);
+        permute_dataset(file, "bnd_node-->group", bnd_order);
+        permute_dataset(file, "bnd_node_weights", bnd_order);
+
+        if (i < levels-1) {
+            std::vector<int> mg_nodes = read_map(file, "node-->mg_node", base_array_index);
+            if (mg_nodes.empty()) {
+                printf("  'node-->mg_node' not present, skipping\n");
+            } else {
+                write_map(file, "node-->mg_node", base_array_index, mg_nodes, 1, nodes, new_node_index[i+1]);
+            }
+        }
+
+        H5Fclose(file);
+    }
+
+    copy_file(input_prefix + input_file, output_prefix + input_file);
+    printf("Reordered deck written to '%s'\n", output_directory.c_str());
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#ifndef SPARSE_TILING_H
+#define SPARSE_TILING_H
+
+#include <algorithm>
+#include <vector>
+
+// Schedule for running the edge flux, boundary flux and node update loops
+// of an RK stage tile by tile, so a tile's node data is still in cache
+// when the next loop reaches it.
+//
+// Nodes are split into contiguous blocks of 'tile_size', which work best
+// on a locality-ordered deck (see mgcfd_reorder). Tiles are given a
+// distance-2 colouring, so tiles of one colour share no node and can run
+// concurrently. Each edge runs in whichever of its two node tiles has the
+// earlier colour, which guarantees its flux contributions land before
+// either node is updated, and before either node's variables change.
+struct sparse_tile_plan {
+    int tile_size;
+    int ntiles;
+    int ncolors;
+
+    // Tiles of colour c are tiles[color_offsets[c] .. color_offsets[c+1])
+    std::vector<int> color_offsets;
+    std::vector<int> tiles;
+
+    // Edges and boundary nodes executed by tile t, in CSR form
+    std::vector<int> edge_offsets;
+    std::vector<int> edges;
+    std::vector<int> bnd_node_offsets;
+    std::vector<int> bnd_nodes;
+};
+
+// Groups 'owner[i]' into per-tile lists, keeping index order within a tile
+inline void sparse_tile_lists(
+    int ntiles,
+    int n,
+    const std::vector<int> &owner,
+    std::vector<int> &offsets,
+    std::vector<int> &lists)
+{
+    offsets.assign(ntiles+1, 0);
+    for (int i=0; i<n; i++) {
+        offsets[owner[i]+1]++;
+    }
+    for (int t=0; t<ntiles; t++) {
+        offsets[t+1] += offsets[t];
+    }
+    lists.resize(n);
+    std::vector<int> fill(offsets.begin(), offsets.end()-1);
+    for (int i=0; i<n; i++) {
+        lists[fill[owner[i]]++] = i;
+    }
+}
+
+// Maps are 0-based. 'num_nodes' must cover every node the maps reference,
+// including any MPI halo.
+inline void sparse_tile_plan_build(
+    sparse_tile_plan* plan,
+    int tile_size,
+    int num_nodes,
+    int num_edges,
+    const int* edge_to_nodes,
+    int num_bnd_nodes,
+    const int* bnd_node_to_node)
+{
+    plan->tile_size = tile_size;
+    plan->ntiles = (num_nodes + tile_size - 1) / tile_size;
+    const int ntiles = plan->ntiles;
+
+    std::vector<std::vector<int> > adjacent(ntiles);
+    for (int e=0; e<num_edges; e++) {
+        int ta = edge_to_nodes[2*e] / tile_size;
+        int tb = edge_to_nodes[2*e+1] / tile_size;
+        if (ta != tb) {
+            adjacent[ta].push_back(tb);
+            adjacent[tb].push_back(ta);
+        }
+    }
+    for (int t=0; t<ntiles; t++) {
+        std::sort(adjacent[t].begin(), adjacent[t].end());
+        adjacent[t].erase(std::unique(adjacent[t].begin(), adjacent[t].end()), adjacent[t].end());
+    }
+
+    // Greedy distance-2 colouring: a tile may not share a colour with a
+    // neighbour, nor with a neighbour's neighbour, as both could increment
+    // the fluxes of the same node
+    std::vector<int> color(ntiles, -1);
+    std::vector<int> seen_by(ntiles+1, -1);
+    plan->ncolors = 0;
+    for (int t=0; t<ntiles; t++) {
+        for (int a : adjacent[t]) {
+            if (color[a] >= 0) {
+                seen_by[color[a]] = t;
+            }
+            for (int b : adjacent[a]) {
+                if (b != t && color[b] >= 0) {
+                    seen_by[color[b]] = t;
+                }
+            }
+        }
+        int c = 0;
+        while (seen_by[c] == t) {
+            c++;
+        }
+        color[t] = c;
+        plan->ncolors = std::max(plan->ncolors, c+1);
+    }
+    sparse_tile_lists(plan->ncolors, ntiles, color, plan->color_offsets, plan->tiles);
+
+    std::vector<int> owner(num_edges);
+    for (int e=0; e<num_edges; e++) {
+        int ta = edge_to_nodes[2*e] / tile_size;
+        int tb = edge_to_nodes[2*e+1] / tile_size;
+        owner[e] = (color[tb] < color[ta]) ? tb : ta;
+    }
+    sparse_tile_lists(ntiles, num_edges, owner, plan->edge_offsets, plan->edges);
+
+    owner.resize(num_bnd_nodes);
+    for (int b=0; b<num_bnd_nodes; b++) {
+        owner[b] = bnd_node_to_node[b] / tile_size;
+    }
+    sparse_tile_lists(ntiles, num_bnd_nodes, owner, plan->bnd_node_offsets, plan->bnd_nodes);
+}
+
+#endif
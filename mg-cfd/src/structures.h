@@ -16,9 +16,11 @@ struct edge_neighbour { int a, b; double x, y, z; };
 struct unit{
   char type;//either M for MG-CFD or C for Coupler unit
   int processes;
+  int first_rank;//units hold consecutive positions of the rank layout starting here, in the order they are listed in cpx_input.cfg
   char coupling_type; //either S for sliding plane or C for CHT 
   std::vector< std::vector<int> > mgcfd_ranks;//each coupler unit has 2 MG-CFD instances, MG-CFD units will only have themselves
   std::vector< std::vector<int> > coupler_ranks;//MG-CFD instances can have multiple couplers
+  std::vector<int> coupler_units;//unit index of each coupler in coupler_ranks
   std::vector<int> mgcfd_units;//the 2 MG-CFD units coupled by this coupler unit
 };
 
@@ -40,6 +40,19 @@
 #define VAR_DENSITY_ENERGY (VAR_MOMENTUM+NDIM)
 #define NVAR (VAR_DENSITY_ENERGY+1)
 
+// Per-node values read by compute_flux_edge_primitives_kernel, packed
+// so that each edge endpoint is a single gather:
+#define PRIM_DENSITY 0
+#define PRIM_MOMENTUM 1
+#define PRIM_DENSITY_ENERGY (PRIM_MOMENTUM+NDIM)
+#define PRIM_SPEED (PRIM_DENSITY_ENERGY+1)
+#define PRIM_SPEED_OF_SOUND (PRIM_SPEED+1)
+#define PRIM_FLUX_MOMENTUM_X (PRIM_SPEED_OF_SOUND+1)
+#define PRIM_FLUX_MOMENTUM_Y (PRIM_FLUX_MOMENTUM_X+NDIM)
+#define PRIM_FLUX_MOMENTUM_Z (PRIM_FLUX_MOMENTUM_Y+NDIM)
+#define PRIM_FLUX_DENSITY_ENERGY (PRIM_FLUX_MOMENTUM_Z+NDIM)
+#define NPRIM (PRIM_FLUX_DENSITY_ENERGY+NDIM)
+
 #define PI 3.1415926535897931
 
 #define MG_UP 0
@@ -2,9 +2,22 @@ static int coupler_cycles = 50;/* number of communication cycles */
 static int mg_conversion_factor = 10; //approx. how many MG cycles equals one production cycle - how many MG cycles run for each coupler cycle.
 static int fenics_conversion_factor = 1; //approx. how many FENICS cycles equals one production cycle - how many FENICS cycles run for each coupler cycle. 
 static int search_freq = 6;/* in every x coupler cycles, run the search routine in cpx*/
+static int interp_donors = 4;/* number of donor nodes each interface node is interpolated from */
+static int rebalance_freq = 6;/* in every x coupler cycles, resize each coupler rank's share of the interface by its measured search and interpolation cost, 0 disables */
+static double rebalance_tolerance = 0.1;/* how far the slowest coupler rank may be above the average cost before the interface is repartitioned */
 static int MUM = 1; //multi-unit mode - 0 is single unit, multi rank, 1 is multi unit
 static bool fastsearch = true; //when true, tree based search is used, else brute force search is used
 static bool ultrafastsearch = true; //mimics the effects of a 'next cell' prediction feature 
 static bool superdebug = false; // Disables coupling entirely and allows applications to run on their own
 static bool debug = false; //controls the amount of output from cpx
-static bool hide_search = false; //controls the overlapping of MG-CFD and cpx Search..
+static int coupling_staleness = 0; //how many coupling cycles a unit may run past the newest coupler reply it holds, 0 waits for every reply
+static bool mxn_redistribution = false; //when true, unit ranks exchange their interface pieces directly with the coupler ranks instead of through both roots
+static bool topology_placement = false; //when true, world ranks are reordered by node so coupler ranks share nodes with the unit ranks that own the interface
+static bool shared_memory_transport = false; //when true, a unit root and a coupler root on the same node exchange the interface through a shared memory window instead of messages
+static bool one_sided_transport = false; //when true, a unit root exposes its interface in an RMA window the coupler root gets from and puts into, so the unit only waits when it needs the reply
+static bool record_calibration = false; //when true, every unit and coupler root appends its measured per-cycle costs to cpx_calibration.dat for cpx --predict
+static bool trace_timeline = false; //when true, every rank records when it solves, packs, sends, waits, searches, interpolates and unpacks, written at exit to cpx_trace.json for chrome://tracing or Perfetto
+static int sliding_codec = 0; //how sliding plane interfaces are packed on the wire: 0 raw doubles, 1 byte shuffle and LZ (lossless), 2 quantised to within codec_error_bound then shuffled and LZ compressed, 3 narrowed to float, 4 narrowed to bfloat16
+static int overset_codec = 0; //the same for overset interfaces
+static int cht_codec = 0; //the same for CHT interfaces
+static double codec_error_bound = 1e-6; //largest absolute error codec 2 may introduce in any interface value
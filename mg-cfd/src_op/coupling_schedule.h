@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "redistribution.h"
+
+#ifndef COUPLING_SCHEDULE_H
+#define COUPLING_SCHEDULE_H
+
+/*
+ * Bounded-staleness coupling on the unit side of one exchange. Every coupling
+ * cycle the unit posts its interface and carries on; replies complete in the
+ * background and the unit only blocks once it is more than staleness coupling
+ * cycles past the newest reply it holds. A staleness of 0 waits for every
+ * reply, as a plain send then receive does. The interface buffer is single,
+ * so a new interface is only written once the coupler has taken the last
+ * one. Replies land in a buffer of their own and are copied to the unit's
+ * boundary as they complete, so the boundary is never written to by a
+ * receive still in flight. How stale the boundary was at every cycle is
+ * counted for the report.
+ */
+struct coupling_schedule{
+  int staleness;//coupling cycles a unit may run past its newest reply
+  int posted;//interfaces sent
+  int received;//replies landed
+  bool send_active;
+  bool recv_active;
+  std::vector<int> lag_cycles;//coupling cycles run with a boundary that many cycles old
+  double *boundary;//newest reply, as the unit uses it
+  std::vector<double> landing;//where replies are received, empty if they go straight to boundary
+};
+
+//returns the buffer the exchange's receives must be bound to, boundary itself when every reply is waited for
+inline double *coupling_schedule_init(struct coupling_schedule *s, int staleness, double *boundary, size_t boundary_size){
+  s->boundary = boundary;
+  s->landing.assign((staleness > 0) ? boundary_size : 0, 0.0);
+  s->staleness = staleness;
+  s->posted = 0;
+  s->received = 0;
+  s->send_active = false;
+  s->recv_active = false;
+  s->lag_cycles.assign(staleness + 1, 0);
+  return s->landing.empty() ? boundary : s->landing.data();
+}
+
+inline void coupling_schedule_landed(struct coupling_schedule *s){
+  s->recv_active = false;
+  s->received++;
+  if(!s->landing.empty()){
+    memcpy(s->boundary, s->landing.data(), s->landing.size() * sizeof(double));
+  }
+}
+
+inline void coupling_schedule_complete_send(struct coupling_schedule *s, struct redistribution *r){
+  if(s->send_active){
+    redistribution_wait_send(r);
+    s->send_active = false;
+  }
+}
+
+//starts the receive of the next reply if one is owed and none is in flight
+inline void coupling_schedule_next_recv(struct coupling_schedule *s, struct redistribution *r){
+  if(!s->recv_active && s->received < s->posted){
+    redistribution_start_recv(r);
+    s->recv_active = true;
+  }
+}
+
+//call before writing the interface buffer, it is free once the last send has completed
+inline void coupling_schedule_ready(struct coupling_schedule *s, struct redistribution *r){
+  coupling_schedule_complete_send(s, r);
+}
+
+inline void coupling_schedule_post(struct coupling_schedule *s, struct redistribution *r){
+  coupling_schedule_complete_send(s, r);
+  redistribution_start_send(r);
+  s->send_active = true;
+  s->posted++;
+  coupling_schedule_next_recv(s, r);
+}
+
+/*
+ * Takes in every reply that has already landed, then blocks until the unit
+ * is within the staleness bound. The send goes first whenever it has to block,
+ * since the coupler only replies to an interface it has received.
+ */
+inline void coupling_schedule_sync(struct coupling_schedule *s, struct redistribution *r){
+  while(s->recv_active && redistribution_test_recv(r)){
+    coupling_schedule_landed(s);
+    coupling_schedule_next_recv(s, r);
+  }
+  while(s->posted - s->received > s->staleness){
+    coupling_schedule_complete_send(s, r);
+    coupling_schedule_next_recv(s, r);
+    redistribution_wait_recv(r);
+    coupling_schedule_landed(s);
+  }
+  coupling_schedule_next_recv(s, r);
+  s->lag_cycles[s->posted - s->received]++;
+}
+
+//completes everything still in flight, the coupler expects a reply to be taken for every interface
+inline void coupling_schedule_finish(struct coupling_schedule *s, struct redistribution *r){
+  coupling_schedule_complete_send(s, r);
+  while(s->received < s->posted){
+    coupling_schedule_next_recv(s, r);
+    redistribution_wait_recv(r);
+    coupling_schedule_landed(s);
+  }
+}
+
+inline void coupling_schedule_print(const struct coupling_schedule *s, const char *unit_name, int unit_num){
+  printf("%s %d boundary staleness (coupling cycles old: cycles run)", unit_name, unit_num);
+  for(int lag = 0; lag <= s->staleness; lag++){
+    printf(" %d:%d", lag, s->lag_cycles[lag]);
+  }
+  printf("\n");
+}
+#endif
@@ -1,3 +1,4 @@
 #include "../src/structures.h"
+#include "input_decks.h"
 
-int main_dolfinx(int, char**, MPI_Fint, int, struct unit[], struct locators[]);
+int main_dolfinx(int, char**, MPI_Fint, int, struct unit[], struct input_decks *);
@@ -74,6 +74,12 @@ void op_par_loop_get_min_dt_kernel(char const *, op_set,
   op_arg,
   op_arg );
 
+void op_par_loop_copy_calculate_min_dt_kernel(char const *, op_set,
+  op_arg,
+  op_arg,
+  op_arg,
+  op_arg );
+
 void op_par_loop_compute_step_factor_kernel(char const *, op_set,
   op_arg,
   op_arg,
@@ -87,6 +93,17 @@ void op_par_loop_compute_flux_edge_kernel(char const *, op_set,
   op_arg,
   op_arg );
 
+void op_par_loop_compute_node_primitives_kernel(char const *, op_set,
+  op_arg,
+  op_arg );
+
+void op_par_loop_compute_flux_edge_primitives_kernel(char const *, op_set,
+  op_arg,
+  op_arg,
+  op_arg,
+  op_arg,
+  op_arg );
+
 void op_par_loop_compute_bnd_node_flux_kernel(char const *, op_set,
   op_arg,
   op_arg,
@@ -100,6 +117,14 @@ void op_par_loop_time_step_kernel(char const *, op_set,
   op_arg,
   op_arg );
 
+void op_par_loop_time_step_min_dt_kernel(char const *, op_set,
+  op_arg,
+  op_arg,
+  op_arg,
+  op_arg,
+  op_arg,
+  op_arg );
+
 void op_par_loop_indirect_rw_kernel(char const *, op_set,
   op_arg,
   op_arg,
@@ -120,6 +145,13 @@ void op_par_loop_count_bad_vals(char const *, op_set,
   op_arg,
   op_arg );
 
+void op_par_loop_residual_rms_kernel(char const *, op_set,
+  op_arg,
+  op_arg,
+  op_arg,
+  op_arg,
+  op_arg );
+
 void op_par_loop_up_pre_kernel(char const *, op_set,
   op_arg,
   op_arg );
@@ -170,6 +202,15 @@ void op_par_loop_identify_differences(char const *, op_set,
 void op_par_loop_count_non_zeros(char const *, op_set,
   op_arg,
   op_arg );
+
+#ifdef SPARSE_TILING
+// Implemented by the openmp backend, see openmp/sparse_tiled_rk_stage_kernel.cpp
+void op_par_loop_sparse_tiled_rk_stage(char const *, int, bool,
+  op_set, op_arg, op_arg, op_arg, op_arg, op_arg,
+  op_set, op_arg, op_arg, op_arg, op_arg,
+  op_set, op_arg, op_arg, op_arg, op_arg, op_arg, op_arg );
+#endif
+
 #ifdef OPENACC
 #ifdef __cplusplus
 }
@@ -213,8 +254,13 @@ config conf;
 #include "validation.h"
 #include "indirect_rw.h"
 #include "coupler_config.h"
+#include "redistribution.h"
+#include "coupling_schedule.h"
+#include "input_decks.h"
+#include "perf_model.h"
+#include "trace.h"
 
-int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, struct unit units[], struct locators relative_positions[])
+int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, struct unit units[], struct input_decks *decks)
 {
     #ifdef NANCHECK
         feenableexcept(FE_ALL_EXCEPT & ~FE_INEXACT);
@@ -238,37 +284,13 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
     /* If the user wants to load different MG-CFD input files for different instances */
     if(strcmp(input_file_name, "file")==0){
         
-        /* The input flag must be set to 'file' and input file names */
+        /* The input flag must be set to 'file' and input file names, read from mg_files.input at startup */
         printf("Reading input from file\n");
-        FILE *mg_files = fopen("mg_files.input", "r");
-        size_t line_buf_size = 0;
-        ssize_t line_size;
-        std::vector<std::string> file_names;
-        std::string temp_string;
-        char *line_buf = NULL;
-
-        if(mg_files == NULL){
-            fprintf(stderr, "Can't open input file mg_files.input\n");
+        if(decks->mg_files.size() < (size_t) instance_number){
+            fprintf(stderr, "Can't find input file for instance %d in mg_files.input\n", instance_number);
             return 1;
         }
-        
-        line_size = getline(&line_buf, &line_buf_size, mg_files);
-
-        while (line_size >= 0){
-            /* Increment our line count */
-            file_names.push_back(line_buf);
-
-            /* Get the next line */
-            line_size = getline(&line_buf, &line_buf_size, mg_files);
-        }
-        temp_string = file_names[instance_number - 1];
-
-        free(line_buf);
-        line_buf = NULL;
-        
-        
-        fclose(mg_files);
-        temp_string.erase(std::remove(temp_string.begin(), temp_string.end(), '\n'), temp_string.cend());
+        std::string temp_string = decks->mg_files[instance_number - 1];
         /* Required filename is found at vector index of the instance number */
         strcpy(input_file_name, temp_string.c_str());
     }
@@ -323,6 +345,16 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
     op_printf("MG-CFD Instance %s running!\n", filename);
     op_printf("MG-CFD Instance %s output is saved in file %s\n", filename, default_name);
 
+    #ifdef SPARSE_TILING
+        if (conf.sparse_tiled_levels != 0 && !conf.fuse_node_kernels) {
+            op_printf("WARNING: sparse tiling needs fuse_node_kernels, RK stages will not be tiled\n");
+        }
+    #else
+        if (conf.sparse_tiled_levels != 0) {
+            op_printf("WARNING: sparse tiling is only built into the openmp binaries, RK stages will not be tiled\n");
+        }
+    #endif
+
 	//Set number of cycles
 	conf.num_cycles = mg_conversion_factor * coupler_cycles;
     
@@ -427,6 +459,7 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
            p_step_factors[levels],
            p_fluxes[levels];
     op_dat p_up_scratch[levels];
+    op_dat p_node_primitives[levels];
 
     // Setup OP2
     char* op_name = alloc<char>(100);
@@ -586,6 +619,13 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
             sprintf(op_name, "p_fluxes_L%d", i);
             p_fluxes[i] = op_decl_dat_temp_char(op_nodes[i], NVAR, "double", sizeof(double), op_name);
 
+            if (conf.flux_precompute) {
+                sprintf(op_name, "p_node_primitives_L%d", i);
+                p_node_primitives[i] = op_decl_dat_temp_char(op_nodes[i], NPRIM, "double", sizeof(double), op_name);
+            } else {
+                p_node_primitives[i] = NULL;
+            }
+
             if (i > 0) {
                 sprintf(op_name, "p_up_scratch_L%d", i);
                 p_up_scratch[i] = op_decl_dat_temp_char(op_nodes[i], 1, "int", sizeof(double), op_name);
@@ -644,10 +684,7 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
   
     MPI_Gather(&internal_rank, 1, MPI_INT, ranks, 1, MPI_INT, 0, mgcfd_comm);
 
-    int worldrank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &worldrank); 
- 
-    int mgcfd_unit_num = relative_positions[worldrank].placelocator;
+    int mgcfd_unit_num = instance_number;
     int unit_count = 0;
     int mgcfd_count = 1;//since units start from 1
     bool found = false;
@@ -682,48 +719,69 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
                     
 
     int ranks_per_coupler;
-    if (internal_rank == MPI_ROOT) {
-        for(int z = 0; z < total_coupler_unit_count; z++){
-            ranks_per_coupler = units[unit_count].coupler_ranks[z].size();
-            coupler_rank = units[unit_count].coupler_ranks[z][0];
-            int coupler_position = relative_positions[coupler_rank].placelocator;
-            found = false;
-            int unit_count_2 = 0;
-            int coupler_unit_count = 1;
-            while(!found){//this is used to find out the unit index of the coupler unit we want
-                if(units[unit_count_2].type == 'C' && coupler_unit_count == coupler_position){
-                found=true;
-                }else{
-                    if(units[unit_count_2].type == 'C'){
-                        coupler_unit_count++;
-                    }
-                    unit_count_2++;
-                }
-            }
-
-            if(units[unit_count_2].coupling_type == 'S' || units[unit_count_2].coupling_type == 'C'){
-                boundary_nodes_size = round(nodes_size * 0.0042);
-            }else if(units[unit_count_2].coupling_type == 'O'){
-                //OVERSET boundary is much larger to emulate the larger interface needed due to stability issues with CFD-Combustion interaction
-                boundary_nodes_size = round(nodes_size * 0.05);
-            }
+    std::vector<struct redistribution> exchanges(total_coupler_unit_count);//direct exchanges with the coupler ranks, one per coupler unit
+    for(int z = 0; z < total_coupler_unit_count; z++){
+        ranks_per_coupler = units[unit_count].coupler_ranks[z].size();
+        coupler_rank = units[unit_count].coupler_ranks[z][0];
+        int unit_count_2 = units[unit_count].coupler_units[z];//unit index of the coupler unit we want
+
+        if(units[unit_count_2].coupling_type == 'S' || units[unit_count_2].coupling_type == 'C'){
+            boundary_nodes_size = round(nodes_size * 0.0042);
+        }else if(units[unit_count_2].coupling_type == 'O'){
+            //OVERSET boundary is much larger to emulate the larger interface needed due to stability issues with CFD-Combustion interaction
+            boundary_nodes_size = round(nodes_size * 0.05);
+        }
+        if (internal_rank == MPI_ROOT) {
             for(int z2 = 0; z2 < ranks_per_coupler; z2++){
                 MPI_Send(&boundary_nodes_size, 1, MPI_DOUBLE, units[unit_count].coupler_ranks[z][z2], 0, MPI_COMM_WORLD);//this sends the node sizes to each of the coupler ranks of each of the coupler units
             }
         }
+        int exchange_vars = (units[unit_count_2].coupling_type == 'S') ? 5 : 1;
+        if(mxn_redistribution){
+            //the coupler root replies with both interface sizes, which every rank needs to find the coupler ranks its piece goes to
+            double interface_sizes[2];
+            if (internal_rank == MPI_ROOT) {
+                MPI_Recv(interface_sizes, 2, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            }
+            MPI_Bcast(interface_sizes, 2, MPI_DOUBLE, 0, mgcfd_comm);
+            bool is_left = (units[unit_count_2].mgcfd_ranks[0][0] == units[unit_count].mgcfd_ranks[0][0]);
+            redistribution_unit_schedule(&exchanges[z], units[unit_count].coupler_ranks[z], interface_sizes[0], interface_sizes[1], is_left, internal_rank, internal_size, exchange_vars);
+        }else if(internal_rank == MPI_ROOT){
+            redistribution_root_schedule(&exchanges[z], coupler_rank, boundary_nodes_size, -1, 0, exchange_vars);
+        }
     }
 
-    double *p_variables_data = (double*) malloc(nodes_size * NVAR * sizeof(double));
-    double *p_variables_recv = (double*) malloc(nodes_size * NVAR * sizeof(double));
+    double *p_variables_data;
+    double *p_variables_recv;
+    //with a single coupler on the same node the root fetches the interface straight into shared memory the coupler reads
+    if(internal_rank == MPI_ROOT && shared_memory_transport && !mxn_redistribution && coupling_staleness == 0 && total_coupler_unit_count == 1
+        && redistribution_share(&exchanges[0], 0, true, nodes_size * NVAR)){
+        p_variables_data = exchanges[0].pieces[0].shared_send;
+        p_variables_recv = exchanges[0].pieces[0].shared_recv;
+    }else{
+        p_variables_data = (double*) malloc(nodes_size * NVAR * sizeof(double));
+        p_variables_recv = (double*) malloc(nodes_size * NVAR * sizeof(double));
+    }
+    //otherwise it can expose the interface for the coupler to get and put when ready
+    if(internal_rank == MPI_ROOT && one_sided_transport && !mxn_redistribution && total_coupler_unit_count == 1 && exchanges[0].pieces[0].shared_send == NULL){
+        redistribution_expose(&exchanges[0], 0, true, nodes_size * NVAR);
+    }
+    std::vector<struct coupling_schedule> schedules(total_coupler_unit_count);
+    for(int z = 0; z < total_coupler_unit_count; z++){
+        double *landing = coupling_schedule_init(&schedules[z], coupling_staleness, p_variables_recv, nodes_size * NVAR);
+        char coupling_type = units[units[unit_count].coupler_units[z]].coupling_type;
+        redistribution_compress(&exchanges[z], codec_select(coupling_type, sliding_codec, overset_codec, cht_codec), codec_error_bound);
+        redistribution_bind(&exchanges[z], p_variables_data, p_variables_data, landing, landing);
+    }
+    struct trace timeline;
+    trace_init(&timeline, trace_timeline, "MG-CFD " + std::to_string(mgcfd_unit_num), unit_count, internal_rank);
+    int coupling_cycle = 0;
+    double solve_start = trace_now();//the solver runs from the end of one coupling to the start of the next
 
-    std::chrono::duration<double> total_seconds;
-	std::chrono::duration<double> wait_seconds;
+    std::chrono::duration<double> total_seconds = std::chrono::duration<double>::zero();
+	std::chrono::duration<double> wait_seconds = std::chrono::duration<double>::zero();
 	std::chrono::duration<double> elapsed_seconds;
 	int z;
-	int coupler_position;
-	int unit_count_2;
-	int coupler_unit_count;
-	int coupler_vars;
 	int rkCycle;
 	std::chrono::steady_clock::time_point start;
 	std::chrono::steady_clock::time_point end;
@@ -741,8 +799,10 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
             }
         #endif
 
-        if((i != prev_cycle && ((i+1) % mg_conversion_factor) == 0) || (hide_search == true && i != prev_cycle && (((i+1) % mg_conversion_factor) == mg_conversion_factor - 1))){
+        if(i != prev_cycle && ((i+1) % mg_conversion_factor) == 0){
             prev_cycle=i;
+            trace_record(&timeline, TRACE_SOLVE, solve_start, coupling_cycle);
+            double trace_start = trace_now();
 
             op_dat temp_dat_l0 = (op_dat) malloc(sizeof(op_dat_core));
             op_set set_l0 = (op_set) malloc(sizeof(op_set_core));
@@ -763,71 +823,32 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
             temp_dat_l0->type = p_variables[0]->type;
             temp_dat_l0->size = p_variables[0]->size;
 
+            if(internal_rank == MPI_ROOT || mxn_redistribution){
+                for(z = 0; z < total_coupler_unit_count; z++){
+                    coupling_schedule_ready(&schedules[z], &exchanges[z]);
+                }
+            }
             op_fetch_data(temp_dat_l0, p_variables_data);
+            trace_record(&timeline, TRACE_PACK, trace_start, coupling_cycle);
             
-            if(internal_rank == MPI_ROOT){
-                if(hide_search == true){
-                    op_printf("MG_CFD cycle %d comms starting\n", ((int) (i+1) / mg_conversion_factor));
-                } else if (hide_search == false && ((i+1 % mg_conversion_factor) != mg_conversion_factor - 1)){
-                    op_printf("MG-CFD cycle %d comms starting\n", ((int) (i+1) / mg_conversion_factor));
-                }
+            if(internal_rank == MPI_ROOT || mxn_redistribution){
+                op_printf("MG-CFD cycle %d comms starting\n", ((int) (i+1) / mg_conversion_factor));
 
+                //post this cycle's interface and only wait for replies once the boundary would be too stale
                 for(z = 0; z < total_coupler_unit_count; z++){
-                    coupler_rank = units[unit_count].coupler_ranks[z][0];
-					coupler_position = relative_positions[coupler_rank].placelocator;
-					found = false;
-					unit_count_2 = 0;
-					coupler_unit_count = 1;
-					while(!found){//this is used to find out the unit index of the coupler unit we want
-						if(units[unit_count_2].type == 'C' && coupler_unit_count == coupler_position){
-						found=true;
-						}else{
-							if(units[unit_count_2].type == 'C'){
-								coupler_unit_count++;
-							}
-							unit_count_2++;
-						}
-					}
-					coupler_vars = 0;
-					if(units[unit_count_2].coupling_type == 'S'){
-						coupler_vars = 5;
-					}else if(units[unit_count_2].coupling_type == 'C' || units[unit_count_2].coupling_type == 'O'){
-						coupler_vars = 1;
-					}
 					start1 = std::chrono::steady_clock::now();
-                    if(hide_search == true){
-                        if((i % (search_freq*mg_conversion_factor)) == 0){
-                            op_printf("Cycle %d - search taking place\n", (i+1) % mg_conversion_factor);
-                            MPI_Send(p_variables_data, boundary_nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD);
-							end1 = std::chrono::steady_clock::now();
-							wait_seconds += end1-start1;
-                        }else if((i % mg_conversion_factor) == mg_conversion_factor - 1){
-
-                            start = std::chrono::steady_clock::now();
-                            MPI_Recv(p_variables_recv, boundary_nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                            end = std::chrono::steady_clock::now();
-                            elapsed_seconds = end-start;
-                            total_seconds += elapsed_seconds;
-                        }else{
-                            MPI_Send(p_variables_data, boundary_nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD);
-							end1 = std::chrono::steady_clock::now();
-							wait_seconds += end1-start1;
-                            start = std::chrono::steady_clock::now();
-                            MPI_Recv(p_variables_recv, boundary_nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                            end = std::chrono::steady_clock::now();
-                            elapsed_seconds = end-start;
-                            total_seconds += elapsed_seconds;
-                        }
-                    }else{
-                        MPI_Send(p_variables_data, boundary_nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD);
-						end1 = std::chrono::steady_clock::now();
-						wait_seconds += end1-start1;
-						start = std::chrono::steady_clock::now();
-                        MPI_Recv(p_variables_recv, boundary_nodes_size * coupler_vars, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                        end = std::chrono::steady_clock::now();
-                        elapsed_seconds = end-start;
-                        total_seconds += elapsed_seconds;
-                    }
+                    trace_start = trace_now();
+                    coupling_schedule_post(&schedules[z], &exchanges[z]);
+                    trace_record(&timeline, TRACE_SEND, trace_start, coupling_cycle);
+					end1 = std::chrono::steady_clock::now();
+					wait_seconds += end1-start1;
+					start = std::chrono::steady_clock::now();
+                    trace_start = trace_now();
+                    coupling_schedule_sync(&schedules[z], &exchanges[z]);
+                    trace_record(&timeline, TRACE_WAIT, trace_start, coupling_cycle);
+                    end = std::chrono::steady_clock::now();
+                    elapsed_seconds = end-start;
+                    total_seconds += elapsed_seconds;
                 }
             }
 
@@ -835,34 +856,54 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
             free(temp_dat_l0->data);
             free(temp_dat_l0->set);
             free(temp_dat_l0);
+            coupling_cycle++;
+            solve_start = trace_now();
         }
         
 
 
-        op_par_loop_copy_double_kernel("copy_double_kernel",op_nodes[level],
-                    op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_WRITE));
-
-        // for the first iteration we compute the time step
-        op_par_loop_calculate_dt_kernel("calculate_dt_kernel",op_nodes[level],
-                    op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
-                    op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_WRITE));
         min_dt = std::numeric_limits<double>::max();
-        op_par_loop_get_min_dt_kernel("get_min_dt_kernel",op_nodes[level],
-                    op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_READ),
-                    op_arg_gbl(&min_dt,1,"double",OP_MIN));
+        if (conf.fuse_node_kernels) {
+            // save the variables and find the time step in one pass
+            op_par_loop_copy_calculate_min_dt_kernel("copy_calculate_min_dt_kernel",op_nodes[level],
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_WRITE),
+                        op_arg_gbl(&min_dt,1,"double",OP_MIN));
+        } else {
+            op_par_loop_copy_double_kernel("copy_double_kernel",op_nodes[level],
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_WRITE));
+
+            // for the first iteration we compute the time step
+            op_par_loop_calculate_dt_kernel("calculate_dt_kernel",op_nodes[level],
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                        op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_WRITE));
+            op_par_loop_get_min_dt_kernel("get_min_dt_kernel",op_nodes[level],
+                        op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_READ),
+                        op_arg_gbl(&min_dt,1,"double",OP_MIN));
+        }
         if (min_dt < 0.0f) {
           sprintf(buffer,"Fatal error during 'step factor' calculation, min_dt = %.5e\n", min_dt);
           op_print_file(buffer, fp);
           op_exit();
           return 1;
         }
-        op_par_loop_compute_step_factor_kernel("compute_step_factor_kernel",op_nodes[level],
-                    op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
-                    op_arg_gbl(&min_dt,1,"double",OP_READ),
-                    op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_WRITE));
+        // time_step_min_dt_kernel forms the step factors itself, so they are
+        // only stored when they are output
+        if (!conf.fuse_node_kernels || conf.output_step_factors) {
+            op_par_loop_compute_step_factor_kernel("compute_step_factor_kernel",op_nodes[level],
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                        op_arg_gbl(&min_dt,1,"double",OP_READ),
+                        op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_WRITE));
+        }
+
+        #ifdef SPARSE_TILING
+            // the tiled chain ends with the fused node update
+            bool tile_rk_stages = conf.fuse_node_kernels && ((conf.sparse_tiled_levels >> level) & 1);
+        #endif
 		
         for (rkCycle=0; rkCycle<RK; rkCycle++)
         {
@@ -871,12 +912,54 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
                 op_print_file(buffer, fp);
             #endif
 
-            op_par_loop_compute_flux_edge_kernel("compute_flux_edge_kernel",op_edges[level],
-                        op_arg_dat(p_variables[level],0,p_edge_to_nodes[level],5,"double",OP_READ),
-                        op_arg_dat(p_variables[level],1,p_edge_to_nodes[level],5,"double",OP_READ),
-                        op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
-                        op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
-                        op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC));
+            if (conf.flux_precompute) {
+                op_par_loop_compute_node_primitives_kernel("compute_node_primitives_kernel",op_nodes[level],
+                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_node_primitives[level],-1,OP_ID,19,"double",OP_WRITE));
+            }
+
+            #ifdef SPARSE_TILING
+            if (tile_rk_stages) {
+                op_dat flux_input = conf.flux_precompute ? p_node_primitives[level] : p_variables[level];
+                int flux_input_dim = conf.flux_precompute ? NPRIM : NVAR;
+                op_par_loop_sparse_tiled_rk_stage("sparse_tiled_rk_stage", conf.sparse_tile_size, conf.flux_precompute,
+                            op_edges[level],
+                            op_arg_dat(flux_input,0,p_edge_to_nodes[level],flux_input_dim,"double",OP_READ),
+                            op_arg_dat(flux_input,1,p_edge_to_nodes[level],flux_input_dim,"double",OP_READ),
+                            op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
+                            op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC),
+                            op_bnd_nodes[level],
+                            op_arg_dat(p_bnd_node_groups[level],-1,OP_ID,1,"int",OP_READ),
+                            op_arg_dat(p_bnd_node_weights[level],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_variables[level],0,p_bnd_node_to_node[level],5,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],0,p_bnd_node_to_node[level],5,"double",OP_INC),
+                            op_nodes[level],
+                            op_arg_gbl(&rkCycle,1,"int",OP_READ),
+                            op_arg_gbl(&min_dt,1,"double",OP_READ),
+                            op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_INC),
+                            op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_WRITE));
+                continue;
+            }
+            #endif
+
+            if (conf.flux_precompute) {
+                op_par_loop_compute_flux_edge_primitives_kernel("compute_flux_edge_primitives_kernel",op_edges[level],
+                            op_arg_dat(p_node_primitives[level],0,p_edge_to_nodes[level],19,"double",OP_READ),
+                            op_arg_dat(p_node_primitives[level],1,p_edge_to_nodes[level],19,"double",OP_READ),
+                            op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
+                            op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC));
+            } else {
+                op_par_loop_compute_flux_edge_kernel("compute_flux_edge_kernel",op_edges[level],
+                            op_arg_dat(p_variables[level],0,p_edge_to_nodes[level],5,"double",OP_READ),
+                            op_arg_dat(p_variables[level],1,p_edge_to_nodes[level],5,"double",OP_READ),
+                            op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
+                            op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC));
+            }
 
             op_par_loop_compute_bnd_node_flux_kernel("compute_bnd_node_flux_kernel",op_bnd_nodes[level],
                         op_arg_dat(p_bnd_node_groups[level],-1,OP_ID,1,"int",OP_READ),
@@ -884,43 +967,58 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
                         op_arg_dat(p_variables[level],0,p_bnd_node_to_node[level],5,"double",OP_READ),
                         op_arg_dat(p_fluxes[level],0,p_bnd_node_to_node[level],5,"double",OP_INC));
 
-            op_par_loop_time_step_kernel("time_step_kernel",op_nodes[level],
-                        op_arg_gbl(&rkCycle,1,"int",OP_READ),
-                        op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_READ),
-                        op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_INC),
-                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
-                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_WRITE));
-
-            op_par_loop_indirect_rw_kernel("indirect_rw_kernel",op_edges[level],
-                        op_arg_dat(p_variables[level],0,p_edge_to_nodes[level],5,"double",OP_READ),
-                        op_arg_dat(p_variables[level],1,p_edge_to_nodes[level],5,"double",OP_READ),
-                        op_arg_dat(p_edge_weights[level],-1,OP_ID,3,"double",OP_READ),
-                        op_arg_dat(p_fluxes[level],0,p_edge_to_nodes[level],5,"double",OP_INC),
-                        op_arg_dat(p_fluxes[level],1,p_edge_to_nodes[level],5,"double",OP_INC));
-            op_par_loop_zero_5d_array_kernel("zero_5d_array_kernel",op_nodes[level],
-                        op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_WRITE));
+            if (conf.fuse_node_kernels) {
+                op_par_loop_time_step_min_dt_kernel("time_step_min_dt_kernel",op_nodes[level],
+                            op_arg_gbl(&rkCycle,1,"int",OP_READ),
+                            op_arg_gbl(&min_dt,1,"double",OP_READ),
+                            op_arg_dat(p_volumes[level],-1,OP_ID,1,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_INC),
+                            op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_WRITE));
+            } else {
+                op_par_loop_time_step_kernel("time_step_kernel",op_nodes[level],
+                            op_arg_gbl(&rkCycle,1,"int",OP_READ),
+                            op_arg_dat(p_step_factors[level],-1,OP_ID,1,"double",OP_READ),
+                            op_arg_dat(p_fluxes[level],-1,OP_ID,5,"double",OP_INC),
+                            op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_WRITE));
+            }
         }
 
-        op_par_loop_residual_kernel("residual_kernel",op_nodes[level],
-                    op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                    op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_WRITE));
-        if (level == 0) {
+        if (conf.fuse_node_kernels && level == 0) {
             rms = 0.0;
-            op_par_loop_calc_rms_kernel("calc_rms_kernel",op_nodes[level],
-                        op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_READ),
-                        op_arg_gbl(&rms,1,"double",OP_INC));
+            op_par_loop_residual_rms_kernel("residual_rms_kernel",op_nodes[level],
+                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_WRITE),
+                        op_arg_gbl(&rms,1,"double",OP_INC),
+                        op_arg_gbl(&bad_val_count,1,"int",OP_INC));
+        } else {
+            op_par_loop_residual_kernel("residual_kernel",op_nodes[level],
+                        op_arg_dat(p_old_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                        op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_WRITE));
+        }
+        if (level == 0) {
+            if (!conf.fuse_node_kernels) {
+                rms = 0.0;
+                op_par_loop_calc_rms_kernel("calc_rms_kernel",op_nodes[level],
+                            op_arg_dat(p_residuals[level],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_gbl(&rms,1,"double",OP_INC));
+            }
             rms = sqrt(rms / double(op_get_size(op_nodes[level])));
             // op_printf(" (RMS = %.3e)", rms);
             // Until I get the HDF5 meshes working correctly, no point displaying incorrect RMS.
 
-            #ifdef OPENACC
-              // count_bad_vals() invokes isnan(), unsupported with OpenACC.
-            #else
-                op_par_loop_count_bad_vals("count_bad_vals",op_nodes[level],
-                            op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
-                            op_arg_gbl(&bad_val_count,1,"int",OP_INC));
-            #endif
+            if (!conf.fuse_node_kernels) {
+                #ifdef OPENACC
+                  // count_bad_vals() invokes isnan(), unsupported with OpenACC.
+                #else
+                    op_par_loop_count_bad_vals("count_bad_vals",op_nodes[level],
+                                op_arg_dat(p_variables[level],-1,OP_ID,5,"double",OP_READ),
+                                op_arg_gbl(&bad_val_count,1,"int",OP_INC));
+                #endif
+            }
             if (bad_val_count > 0) {
                 op_print_file("Bad variable values detected, aborting\n", fp);
                 op_exit();
@@ -999,6 +1097,16 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
         }
     }
 
+    trace_record(&timeline, TRACE_SOLVE, solve_start, coupling_cycle);
+    if(internal_rank == MPI_ROOT || mxn_redistribution){
+        for(z = 0; z < total_coupler_unit_count; z++){
+            coupling_schedule_finish(&schedules[z], &exchanges[z]);
+            if(internal_rank == MPI_ROOT){
+                coupling_schedule_print(&schedules[z], "MG-CFD", mgcfd_unit_num);
+            }
+        }
+    }
+
     op_print_file("\n", fp);
     op_print_file("Compute complete\n", fp);
 
@@ -1013,6 +1121,11 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
 	sprintf(buffer,"Time waiting coupling = %f\n", wait_seconds.count());
 	op_print_file(buffer, fp);
 
+    //the solver's share of a coupling cycle is whatever the root did not spend posting and waiting
+    if(record_calibration && internal_rank == MPI_ROOT && schedules[0].posted > 0){
+        perf_model_record("unit", 'M', unit_count, internal_size, nodes_size, (wall_t2 - wall_t1 - total_seconds.count() - wait_seconds.count()) / schedules[0].posted);
+    }
+
     op_printf("MG-CFD Instance %s has finished!\n", filename);
 
     // Write summary performance data to stdout:
@@ -1027,6 +1140,71 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
 
     op_timings_to_csv(csv_out_filepath.c_str());
 
+    if (conf.indirect_rw_benchmark) {
+        // indirect_rw_kernel moves the same data as compute_flux_edge_kernel
+        // with almost no arithmetic, so comparing the two shows how close the
+        // flux loop gets to the bandwidth bound of its gathers and scatters.
+        // It runs after the OP2 timings are reported, so as not to add to them
+        op_print_file("-----------------------------------------------------\n", fp);
+        sprintf(buffer,"Indirect R/W benchmark, %d repeats of each edge loop:\n", conf.indirect_rw_repeats);
+        op_print_file(buffer, fp);
+        for (int l=0; l<levels; l++) {
+            double bench_cpu, bench_t1, bench_t2, flux_time, rw_time;
+            double edges = double(op_get_size(op_edges[l])) * conf.indirect_rw_repeats;
+            int gathered = conf.flux_precompute ? NPRIM : NVAR;
+
+            if (conf.flux_precompute) {
+                op_par_loop_compute_node_primitives_kernel("compute_node_primitives_kernel",op_nodes[l],
+                            op_arg_dat(p_variables[l],-1,OP_ID,5,"double",OP_READ),
+                            op_arg_dat(p_node_primitives[l],-1,OP_ID,19,"double",OP_WRITE));
+            }
+            op_timers(&bench_cpu, &bench_t1);
+            for (int r=0; r<conf.indirect_rw_repeats; r++) {
+                if (conf.flux_precompute) {
+                    op_par_loop_compute_flux_edge_primitives_kernel("compute_flux_edge_primitives_kernel",op_edges[l],
+                                op_arg_dat(p_node_primitives[l],0,p_edge_to_nodes[l],19,"double",OP_READ),
+                                op_arg_dat(p_node_primitives[l],1,p_edge_to_nodes[l],19,"double",OP_READ),
+                                op_arg_dat(p_edge_weights[l],-1,OP_ID,3,"double",OP_READ),
+                                op_arg_dat(p_fluxes[l],0,p_edge_to_nodes[l],5,"double",OP_INC),
+                                op_arg_dat(p_fluxes[l],1,p_edge_to_nodes[l],5,"double",OP_INC));
+                } else {
+                    op_par_loop_compute_flux_edge_kernel("compute_flux_edge_kernel",op_edges[l],
+                                op_arg_dat(p_variables[l],0,p_edge_to_nodes[l],5,"double",OP_READ),
+                                op_arg_dat(p_variables[l],1,p_edge_to_nodes[l],5,"double",OP_READ),
+                                op_arg_dat(p_edge_weights[l],-1,OP_ID,3,"double",OP_READ),
+                                op_arg_dat(p_fluxes[l],0,p_edge_to_nodes[l],5,"double",OP_INC),
+                                op_arg_dat(p_fluxes[l],1,p_edge_to_nodes[l],5,"double",OP_INC));
+                }
+            }
+            op_timers(&bench_cpu, &bench_t2);
+            flux_time = bench_t2 - bench_t1;
+
+            op_timers(&bench_cpu, &bench_t1);
+            for (int r=0; r<conf.indirect_rw_repeats; r++) {
+                op_par_loop_indirect_rw_kernel("indirect_rw_kernel",op_edges[l],
+                            op_arg_dat(p_variables[l],0,p_edge_to_nodes[l],5,"double",OP_READ),
+                            op_arg_dat(p_variables[l],1,p_edge_to_nodes[l],5,"double",OP_READ),
+                            op_arg_dat(p_edge_weights[l],-1,OP_ID,3,"double",OP_READ),
+                            op_arg_dat(p_fluxes[l],0,p_edge_to_nodes[l],5,"double",OP_INC),
+                            op_arg_dat(p_fluxes[l],1,p_edge_to_nodes[l],5,"double",OP_INC));
+            }
+            op_timers(&bench_cpu, &bench_t2);
+            rw_time = bench_t2 - bench_t1;
+
+            // the time step leaves the fluxes zeroed, so put them back for any output
+            op_par_loop_zero_5d_array_kernel("zero_5d_array_kernel",op_nodes[l],
+                        op_arg_dat(p_fluxes[l],-1,OP_ID,5,"double",OP_WRITE));
+
+            // per edge: two gathered nodes, the edge weight and two flux increments read and written
+            double flux_bytes = edges * (2*gathered + 3 + 2*2*NVAR) * sizeof(double);
+            double rw_bytes   = edges * (2*NVAR + 3 + 2*2*NVAR) * sizeof(double);
+            sprintf(buffer,"  MG level %d: %s %.3f s, %.2f GB/s; indirect_rw_kernel %.3f s, %.2f GB/s\n", l,
+                    conf.flux_precompute ? "compute_flux_edge_primitives_kernel" : "compute_flux_edge_kernel",
+                    flux_time, flux_bytes / flux_time * 1.0e-9, rw_time, rw_bytes / rw_time * 1.0e-9);
+            op_print_file(buffer, fp);
+        }
+    }
+
     if (conf.validate_result) {
         op_print_file("-----------------------------------------------------\n", fp);
 
@@ -1198,6 +1376,10 @@ int main_mgcfd(int argc, char** argv, MPI_Fint custom, int instance_number, stru
 
     op_print_file_close(fp);
     
+    trace_write(&timeline, mgcfd_comm);
+    for(z = 0; z < total_coupler_unit_count; z++){
+        redistribution_free(&exchanges[z]);
+    }
     //int exit_command = 1;
     //MPI_Send(&exit_command, 1, MPI_INT, coupler_rank, 0, MPI_COMM_WORLD);
     op_exit();
@@ -1,4 +1,5 @@
 #include <mpi.h>
 #include "../src/structures.h"
+#include "input_decks.h"
 
-int main_simpic(int, char**, MPI_Fint, int, struct unit[], struct locators[]);
+int main_simpic(int, char**, MPI_Fint, int, struct unit[], struct input_decks *);
@@ -36,14 +36,19 @@
 #include "copy_double_kernel_veckernel.cpp"
 #include "calculate_dt_kernel_veckernel.cpp"
 #include "get_min_dt_kernel_veckernel.cpp"
+#include "copy_calculate_min_dt_kernel_veckernel.cpp"
 #include "compute_step_factor_kernel_veckernel.cpp"
 #include "compute_flux_edge_kernel_veckernel.cpp"
+#include "compute_node_primitives_kernel_veckernel.cpp"
+#include "compute_flux_edge_primitives_kernel_veckernel.cpp"
 #include "compute_bnd_node_flux_kernel_veckernel.cpp"
 #include "time_step_kernel_veckernel.cpp"
+#include "time_step_min_dt_kernel_veckernel.cpp"
 #include "indirect_rw_kernel_veckernel.cpp"
 #include "residual_kernel_veckernel.cpp"
 #include "calc_rms_kernel_veckernel.cpp"
 #include "count_bad_vals_veckernel.cpp"
+#include "residual_rms_kernel_veckernel.cpp"
 #include "up_pre_kernel_veckernel.cpp"
 #include "up_kernel_veckernel.cpp"
 #include "up_post_kernel_veckernel.cpp"
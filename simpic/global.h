@@ -47,7 +47,6 @@ Scalar xl, xr, L, Ll;
 int ntimesteps;
 Scalar artificalsize;
 struct unit *units_copy;
-struct locators *relative_positions_copy;
 
 int total_coupler_unit_count;
 int unit_count;
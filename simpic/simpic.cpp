@@ -13,6 +13,10 @@
 #include "fields.cpp"
 #include "coupler_config.h"
 #include "../src/structures.h"
+#include "redistribution.h"
+#include "input_decks.h"
+#include "perf_model.h"
+#include "trace.h"
 
 
 inline void lhs(int j)
@@ -307,12 +311,22 @@ void mainloop(Scalar tmax, Scalar dt)
   Scalar transfer_size;
   double interface_size;
   int coupler_rank;
-
+  std::vector<struct redistribution> exchanges(total_coupler_unit_count);//direct exchanges with the coupler ranks, one per coupler unit
+  Scalar *local_interface = NULL;
+  Scalar *local_interface_recv = NULL;
+  int local_interface_size = 0;
+
+  interface_size = std::round(0.05 * 1000000 * artificalsize);
+  int interface_vars = 1;//values per interface node, a sliding plane exchanges 5
+  for(int z = 0; z < total_coupler_unit_count; z++){
+    if(units_copy[units_copy[unit_count].coupler_units[z]].coupling_type == 'S'){
+      interface_vars = 5;
+    }
+  }
   if(rank == 0){
-    interface_size = std::round(0.05 * 1000000 * artificalsize);
-    large_interface = new Scalar[interface_size];
-    large_interface_recv = new Scalar[interface_size];
-    std::fill_n(large_interface, interface_size, 0);
+    large_interface = new Scalar[interface_size * interface_vars];
+    large_interface_recv = new Scalar[interface_size * interface_vars];
+    std::fill_n(large_interface, interface_size * interface_vars, 0);
     if(ng * comm_size > interface_size){
       transfer_size = interface_size;
     }else{
@@ -326,23 +340,102 @@ void mainloop(Scalar tmax, Scalar dt)
       }
     }
   }
+  if(mxn_redistribution){
+    //the coupler root replies with both interface sizes, which every rank needs to find the coupler ranks its piece goes to
+    for(int z = 0; z < total_coupler_unit_count; z++){
+      coupler_rank = units_copy[unit_count].coupler_ranks[z][0];
+      double interface_sizes[2];
+      if(rank == 0){
+        MPI_Recv(interface_sizes, 2, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      }
+      MPI_Bcast(interface_sizes, 2, MPI_DOUBLE, 0, custom_comm);
+      int coupler_unit = units_copy[unit_count].coupler_units[z];
+      bool is_left = (units_copy[coupler_unit].mgcfd_ranks[0][0] == units_copy[unit_count].mgcfd_ranks[0][0]);
+      int exchange_vars = (units_copy[coupler_unit].coupling_type == 'S') ? 5 : 1;
+      redistribution_unit_schedule(&exchanges[z], units_copy[unit_count].coupler_ranks[z], interface_sizes[0], interface_sizes[1], is_left, rank, comm_size, exchange_vars);
+      local_interface_size = std::max(local_interface_size, exchanges[z].local_size * exchange_vars);
+    }
+    local_interface = new Scalar[local_interface_size];
+    local_interface_recv = new Scalar[local_interface_size];
+    for(int z = 0; z < total_coupler_unit_count; z++){
+      char coupling_type = units_copy[units_copy[unit_count].coupler_units[z]].coupling_type;
+      redistribution_compress(&exchanges[z], codec_select(coupling_type, sliding_codec, overset_codec, cht_codec), codec_error_bound);
+      redistribution_bind(&exchanges[z], local_interface, local_interface, local_interface_recv, local_interface_recv);
+    }
+  }else if(rank == 0){
+    //the root sends the whole interface to each coupler root
+    for(int z = 0; z < total_coupler_unit_count; z++){
+      coupler_rank = units_copy[unit_count].coupler_ranks[z][0];
+      char coupling_type = units_copy[units_copy[unit_count].coupler_units[z]].coupling_type;
+      int exchange_vars = (coupling_type == 'S') ? 5 : 1;
+      redistribution_root_schedule(&exchanges[z], coupler_rank, interface_size, -1, 0, exchange_vars);
+      redistribution_compress(&exchanges[z], codec_select(coupling_type, sliding_codec, overset_codec, cht_codec), codec_error_bound);
+      redistribution_bind(&exchanges[z], large_interface, large_interface, large_interface_recv, large_interface_recv);
+    }
+  }
   
+  int work_num = 1;//shown as the n-th work unit, as the units are numbered at launch
+  for(int u = 0; u < unit_count; u++){
+    work_num += (units_copy[u].type != 'C');
+  }
+  struct trace timeline;
+  trace_init(&timeline, trace_timeline, "SIMPIC " + std::to_string(work_num), unit_count, rank);
+  double solve_start = trace_now();//the solver runs from the end of one coupling to the start of the next
+
+  double loop_start = MPI_Wtime();
+  double coupling_time = 0.0;//spent in the coupling block, the rest of the loop is the solver
+  int couplings = 0;
   while(tt < tmax)
     {
       if(count % (ntimesteps/coupler_cycles) == 0 && count < (ntimesteps/coupler_cycles) * coupler_cycles){//this will ensure coupling takes place the right number of times - note that coupling doesn't take place on the final iteration
+        double coupling_start = MPI_Wtime();
+        if(count > 0){
+          trace_record(&timeline, TRACE_SOLVE, solve_start, couplings);
+        }
+        couplings++;
+        double trace_start = trace_now();
         MPI_Barrier(custom_comm);
-        MPI_Gather(narray, ng, MPI_SCALAR, narray_variables, ng, MPI_SCALAR, 0, custom_comm);//gather the SIMPIC mesh data from each of the ranks
-        if(rank == 0){
+        trace_record(&timeline, TRACE_WAIT, trace_start, couplings - 1);
+        if(mxn_redistribution){
+          //each rank sends its own piece of the interface, taken from its part of the mesh
+          trace_start = trace_now();
+          for(int k = 0; k < local_interface_size; k++){
+            local_interface[k] = narray[k % ng];
+          }
+          trace_record(&timeline, TRACE_PACK, trace_start, couplings - 1);
+          for(int z = 0; z < total_coupler_unit_count; z++){
+            trace_start = trace_now();
+            redistribution_send(&exchanges[z]);
+            trace_record(&timeline, TRACE_SEND, trace_start, couplings - 1);
+            trace_start = trace_now();
+            redistribution_recv(&exchanges[z]);
+            trace_record(&timeline, TRACE_WAIT, trace_start, couplings - 1);
+          }
+        }else{
+          trace_start = trace_now();
+          MPI_Gather(narray, ng, MPI_SCALAR, narray_variables, ng, MPI_SCALAR, 0, custom_comm);//gather the SIMPIC mesh data from each of the ranks
+          trace_record(&timeline, TRACE_PACK, trace_start, couplings - 1);
+        }
+        if(rank == 0 && !mxn_redistribution){
           printf("Count is %d, sending from simpic side\n", count);  
+          trace_start = trace_now();
           std::memcpy(large_interface, narray, transfer_size);
+          trace_record(&timeline, TRACE_PACK, trace_start, couplings - 1);
           for(int z = 0; z < total_coupler_unit_count; z++){
-            coupler_rank = units_copy[unit_count].coupler_ranks[z][0];
-            MPI_Send(large_interface, interface_size, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD);
-            MPI_Recv(large_interface_recv, interface_size, MPI_DOUBLE, coupler_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            trace_start = trace_now();
+            redistribution_send(&exchanges[z]);
+            trace_record(&timeline, TRACE_SEND, trace_start, couplings - 1);
+            trace_start = trace_now();
+            redistribution_recv(&exchanges[z]);
+            trace_record(&timeline, TRACE_WAIT, trace_start, couplings - 1);
           }
           printf("Count is %d, receiving from simpic side\n", count); 
         }
+        trace_start = trace_now();
         MPI_Barrier(custom_comm);
+        trace_record(&timeline, TRACE_WAIT, trace_start, couplings - 1);
+        coupling_time += MPI_Wtime() - coupling_start;
+        solve_start = trace_now();
       }
       
       #ifdef DEBUG
@@ -397,7 +490,17 @@ void mainloop(Scalar tmax, Scalar dt)
       #endif
       count++;
     }
+    trace_record(&timeline, TRACE_SOLVE, solve_start, couplings);
+    trace_write(&timeline, custom_comm);
+    if(record_calibration && rank == 0 && couplings > 0){
+      perf_model_record("unit", 'P', unit_count, comm_size, (double) ng * comm_size, (MPI_Wtime() - loop_start - coupling_time) / couplings);
+    }
+    for(int z = 0; z < total_coupler_unit_count; z++){
+      redistribution_free(&exchanges[z]);
+    }
     delete [] narray_variables;
+    delete [] local_interface;
+    delete [] local_interface_recv;
 }
 
 void allocate_particles(void)
@@ -528,54 +631,29 @@ void free_fields(void)
   allocate_arrays(1);
 }
 
-void parsefromfile()
+//parses the arguments of simpic_parameters, which rank 0 read at startup
+void parseparameters(const std::vector<std::string> &parameters)
 {
     int i;
     int nnppcc;   // number of particles per cell
     int nnccpppp; // number of cells per processor
     int nnnttt;   // number of time steps
     int asz; // artificial mesh size for coupling
-    FILE *fp;
-    char filebuffer[100]; // buffer to hold contents from simpic input file
-    int count; // used to count the total number of input parameters (i.e to replace argc)
+    int count; // the total number of input parameters (i.e to replace argc)
     double ddttff, lhsdefault;
-    int array_count; // used to store the current array index
 
-    count = array_count = 0;
     ddttff = lhsdefault = 0.;
     nnppcc = nnccpppp = nnnttt = 0;
 
-    fp = fopen("simpic_parameters", "r");
-    if(fp == NULL){
+    if(parameters.empty()){
         printf("Error: SIMPIC parameter file not found\n");
         Quit();
     }
 
-    if(filebuffer != fgets(filebuffer, 100, fp)){
-        printf("SIMPIC parameter file exists but something went wrong\n");
-        Quit();
-    }
-
-    for (i = 0; filebuffer[i] != '\0'; i++){
-        if (filebuffer[i] == ' ' && filebuffer[i+1] != ' '){
-            count++;
-        }
-    }
-    count++; //increment count since the last word will not have a space after
-
-
-    char* word = strtok(filebuffer," ");
-    char** fiparameters = (char**) calloc(count, sizeof(char*)); //allocate an array of strings
-    fiparameters[array_count] = (char*) calloc(strlen(word) + 1, sizeof(char)); //allocate memory to an individual string
-    strncpy(fiparameters[array_count], word, strlen(word)+1);
-    array_count++;
-    while(word != NULL) {
-        word = strtok(NULL, " ");
-        if (word != NULL) {
-            fiparameters[array_count] = (char*) calloc(strlen(word) + 1, sizeof(char)); //allocate memory to the next individual string
-            strncpy(fiparameters[array_count], word, strlen(word)+1);
-            array_count++;
-        }
+    count = parameters.size();
+    std::vector<const char *> fiparameters(count);
+    for(i = 0; i < count; i++){
+        fiparameters[i] = parameters[i].c_str();
     }
 
     for(i=0; i < count; i++)
@@ -648,13 +726,6 @@ void parsefromfile()
     printf("Dtfactor: %f\n", dtfactor);
     printf("Left hand side voltage: %f\n", lhsvoltage);
     */
-
-    for(i=0; i < count; i++){//free each of the parameter sub-arrays
-        free(fiparameters[i]);
-    }
-    free(fiparameters);//free the parameter array
-
-    fclose(fp);
 }
 
 void parsecmdline(int argc, char **argv)
@@ -772,7 +843,7 @@ void Quit(void)
 
 
 
-int main_simpic(int argc, char** argv, MPI_Fint custom, int instance_number, struct unit units[], struct locators relative_positions[])
+int main_simpic(int argc, char** argv, MPI_Fint custom, int instance_number, struct unit units[], struct input_decks *decks)
 {
   //MPI_Init(&argc, &argv);
   int flag = 0;
@@ -789,7 +860,7 @@ int main_simpic(int argc, char** argv, MPI_Fint custom, int instance_number, str
 
   //parsecmdline(argc, argv);
 
-  parsefromfile();
+  parseparameters(decks->simpic_parameters);
   init();
   
   #ifdef DEBUG
@@ -802,9 +873,7 @@ int main_simpic(int argc, char** argv, MPI_Fint custom, int instance_number, str
   endtime(INIT);
 
   /* Here is where the coupler rank is worked out*/
-  int worldrank;
-  MPI_Comm_rank(MPI_COMM_WORLD, &worldrank);
-  int simpic_unit_num = relative_positions[worldrank].placelocator;
+  int simpic_unit_num = instance_number;
   unit_count = 0;
   int simpic_count = 1;//since units start from 1
   bool found = false;
@@ -829,7 +898,6 @@ int main_simpic(int argc, char** argv, MPI_Fint custom, int instance_number, str
   }
 
   units_copy = units;
-  relative_positions_copy = relative_positions;
 
 
   mainloop(t, dt);
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#ifndef ARENA_H
+#define ARENA_H
+
+/*
+ * Bump allocator for the coupler's raw work arrays: the funnel root's
+ * interface buffers, the scatter/gather chunks and the CHT arrays. They are
+ * carved out of one block that is allocated at setup and released at exit,
+ * so large interfaces never land on the stack. The search and interpolation
+ * buffers are vectors outside the arena.
+ */
+#define ARENA_ALIGN 64 //each array starts on its own cache line
+
+struct arena{
+  char *base;
+  size_t capacity;//bytes in the block
+  size_t used;//bytes handed out so far
+};
+
+//one array to be carved out of the arena, ptr receives its address
+struct arena_request{
+  double **ptr;
+  size_t count;//number of doubles
+};
+
+inline size_t arena_round(size_t bytes){
+  return ((bytes + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN;
+}
+
+inline void *arena_alloc(struct arena *a, size_t bytes){
+  bytes = arena_round(bytes);
+  if(a->used + bytes > a->capacity){
+    fprintf(stderr, "Error: coupler work arena exhausted (%zu of %zu bytes used, %zu requested), aborting...\n", a->used, a->capacity, bytes);
+    exit(1);
+  }
+  void *ptr = a->base + a->used;
+  a->used += bytes;
+  return ptr;
+}
+
+//sizes the arena for all n requests and hands each one its array
+inline void arena_setup(struct arena *a, struct arena_request *requests, int n){
+  a->capacity = 0;
+  a->used = 0;
+  for(int i = 0; i < n; i++){
+    a->capacity += arena_round(requests[i].count * sizeof(double));
+  }
+  void *base = NULL;
+  if(a->capacity > 0 && posix_memalign(&base, ARENA_ALIGN, a->capacity) != 0){
+    fprintf(stderr, "Error: could not allocate the %zu byte coupler work arena, aborting...\n", a->capacity);
+    exit(1);
+  }
+  a->base = (char *) base;
+  for(int i = 0; i < n; i++){
+    *requests[i].ptr = (double *) arena_alloc(a, requests[i].count * sizeof(double));
+  }
+}
+
+inline void arena_free(struct arena *a){
+  free(a->base);
+  a->base = NULL;
+  a->capacity = 0;
+  a->used = 0;
+}
+
+//peak resident set size of this process in kB
+inline long peak_memory_kb(){
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+#endif
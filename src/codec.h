@@ -0,0 +1,375 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#ifndef CODEC_H
+#define CODEC_H
+
+/*
+ * Codecs for interface payloads on the wire. CODEC_LZ splits the doubles
+ * into byte planes, so the slowly varying sign, exponent and leading mantissa
+ * bytes of neighbouring nodes end up next to each other, and then LZ
+ * compresses the planes. CODEC_QUANTISE first rounds every value to a
+ * multiple of twice the error bound above the smallest value, so no value
+ * moves by more than the bound, and compresses the integer codes the same
+ * way. CODEC_FLOAT and CODEC_BFLOAT16 narrow every value to a float, or to
+ * the upper half of one, rounding to nearest even, for half or a quarter of
+ * the bytes on the wire and about 7 or 3 significant digits. A message that
+ * would not shrink is sent as is, so a packed message is never more than
+ * CODEC_HEADER bytes larger than the raw one.
+ *
+ * Packed message: the header below, then the payload.
+ *   byte 0      how the payload is stored, CODEC_STORED_*
+ *   byte 1      bytes per value in the payload before compression
+ *   bytes 4-7   payload bytes
+ *   bytes 8-15  number of values
+ *   bytes 16-23 smallest value, quantised messages only
+ *   bytes 24-31 quantisation step, quantised messages only
+ */
+#define CODEC_RAW 0
+#define CODEC_LZ 1
+#define CODEC_QUANTISE 2
+#define CODEC_FLOAT 3
+#define CODEC_BFLOAT16 4
+
+#define CODEC_STORED_RAW 0 //the values as they are
+#define CODEC_STORED_LZ 1 //byte planes of the values, LZ compressed
+#define CODEC_STORED_QUANTISED 2 //byte planes of the quantised codes, LZ compressed
+#define CODEC_STORED_FLOAT 3 //the values narrowed to float
+#define CODEC_STORED_BFLOAT16 4 //the upper 16 bits of each value's float
+
+#define CODEC_HEADER 32
+#define CODEC_LZ_MIN_MATCH 4
+#define CODEC_LZ_HASH_BITS 14
+
+//codec chosen for a coupler type, as set per type in coupler_config.h
+inline int codec_select(char coupling_type, int sliding, int overset, int cht){
+  return (coupling_type == 'S') ? sliding : ((coupling_type == 'O') ? overset : cht);
+}
+
+//largest packed message for n doubles, whichever codec packed it
+inline size_t codec_bound(size_t n){
+  return CODEC_HEADER + n * sizeof(double) + n * sizeof(double) / 255 + 16;
+}
+
+//plane b holds byte b of every value
+inline void codec_shuffle(const unsigned char *in, size_t n, int width, unsigned char *out){
+  for(int b = 0; b < width; b++){
+    for(size_t i = 0; i < n; i++){
+      out[b * n + i] = in[i * width + b];
+    }
+  }
+}
+
+inline void codec_unshuffle(const unsigned char *in, size_t n, int width, unsigned char *out){
+  for(int b = 0; b < width; b++){
+    for(size_t i = 0; i < n; i++){
+      out[i * width + b] = in[b * n + i];
+    }
+  }
+}
+
+inline unsigned char *codec_lz_length(unsigned char *out, size_t length){
+  for(; length >= 255; length -= 255){
+    *out++ = 255;
+  }
+  *out++ = (unsigned char) length;
+  return out;
+}
+
+inline const unsigned char *codec_lz_read_length(const unsigned char *in, size_t *length){
+  unsigned char byte;
+  do{
+    byte = *in++;
+    *length += byte;
+  }while(byte == 255);
+  return in;
+}
+
+/*
+ * LZ77 in the layout of an LZ4 block: each sequence is a token whose high and
+ * low nibbles are the literal count and the match length beyond the minimum,
+ * a nibble of 15 being continued in further bytes, then the literals, then a
+ * two byte offset back to the match. The last sequence is literals only.
+ * Matches are found through a table of the last position of each hashed 4
+ * byte string. Returns the compressed size, at most n + n / 255 + 16.
+ */
+inline size_t codec_lz_compress(const unsigned char *in, size_t n, unsigned char *out){
+  std::vector<uint32_t> last(1 << CODEC_LZ_HASH_BITS, UINT32_MAX);
+  unsigned char *o = out;
+  size_t anchor = 0;
+  size_t i = 0;
+  while(n >= CODEC_LZ_MIN_MATCH && i + CODEC_LZ_MIN_MATCH <= n){
+    uint32_t word;
+    memcpy(&word, in + i, sizeof(word));
+    uint32_t h = (word * 2654435761u) >> (32 - CODEC_LZ_HASH_BITS);
+    uint32_t candidate = last[h];
+    last[h] = (uint32_t) i;
+    if(candidate == UINT32_MAX || i - candidate > 65535 || memcmp(in + candidate, in + i, CODEC_LZ_MIN_MATCH) != 0){
+      i++;
+      continue;
+    }
+    size_t match = CODEC_LZ_MIN_MATCH;
+    while(i + match < n && in[candidate + match] == in[i + match]){
+      match++;
+    }
+    size_t literals = i - anchor;
+    unsigned char *token = o++;
+    *token = (unsigned char) ((std::min(literals, (size_t) 15) << 4) | std::min(match - CODEC_LZ_MIN_MATCH, (size_t) 15));
+    if(literals >= 15){
+      o = codec_lz_length(o, literals - 15);
+    }
+    memcpy(o, in + anchor, literals);
+    o += literals;
+    uint16_t offset = (uint16_t) (i - candidate);
+    memcpy(o, &offset, sizeof(offset));
+    o += sizeof(offset);
+    if(match - CODEC_LZ_MIN_MATCH >= 15){
+      o = codec_lz_length(o, match - CODEC_LZ_MIN_MATCH - 15);
+    }
+    i += match;
+    anchor = i;
+  }
+  size_t literals = n - anchor;
+  *o++ = (unsigned char) (std::min(literals, (size_t) 15) << 4);
+  if(literals >= 15){
+    o = codec_lz_length(o, literals - 15);
+  }
+  memcpy(o, in + anchor, literals);
+  o += literals;
+  return o - out;
+}
+
+inline void codec_lz_decompress(const unsigned char *in, size_t bytes, unsigned char *out, size_t n){
+  const unsigned char *end = in + bytes;
+  size_t o = 0;
+  while(in < end){
+    unsigned char token = *in++;
+    size_t literals = token >> 4;
+    if(literals == 15){
+      in = codec_lz_read_length(in, &literals);
+    }
+    memcpy(out + o, in, literals);
+    in += literals;
+    o += literals;
+    if(in >= end || o >= n){
+      break;
+    }
+    uint16_t offset;
+    memcpy(&offset, in, sizeof(offset));
+    in += sizeof(offset);
+    size_t match = (token & 15);
+    if(match == 15){
+      in = codec_lz_read_length(in, &match);
+    }
+    match += CODEC_LZ_MIN_MATCH;
+    //matches may overlap what they copy, so byte by byte
+    for(size_t k = 0; k < match; k++, o++){
+      out[o] = out[o - offset];
+    }
+  }
+}
+
+//stores n values of width bytes as byte planes, LZ compressed, returns the payload size or 0 if that would not be smaller
+inline size_t codec_planes(const unsigned char *values, size_t n, int width, unsigned char *payload){
+  std::vector<unsigned char> planes(n * width);
+  codec_shuffle(values, n, width, planes.data());
+  std::vector<unsigned char> packed(n * width + n * width / 255 + 16);
+  size_t bytes = codec_lz_compress(planes.data(), n * width, packed.data());
+  if(bytes >= n * sizeof(double)){
+    return 0;
+  }
+  memcpy(payload, packed.data(), bytes);
+  return bytes;
+}
+
+//records the payload size in the header and returns the size of the whole message
+inline size_t codec_header_size(unsigned char *out, size_t payload_bytes){
+  uint32_t bytes = payload_bytes;
+  memcpy(out + 4, &bytes, sizeof(bytes));
+  return CODEC_HEADER + payload_bytes;
+}
+
+//narrowing and widening loops are kept branch free so they vectorise, returning the largest error they introduce
+inline double codec_narrow_float(const double *in, size_t n, float *out){
+  double error = 0.0;
+  #pragma omp simd reduction(max:error)
+  for(size_t i = 0; i < n; i++){
+    out[i] = (float) in[i];
+    error = std::max(error, fabs(in[i] - (double) out[i]));
+  }
+  return error;
+}
+
+inline void codec_widen_float(const float *in, size_t n, double *out){
+  #pragma omp simd
+  for(size_t i = 0; i < n; i++){
+    out[i] = in[i];
+  }
+}
+
+//rounds the float to its upper 16 bits, to nearest and ties to even, as bfloat16 does
+inline double codec_narrow_bfloat16(const double *in, size_t n, uint16_t *out){
+  double error = 0.0;
+  #pragma omp simd reduction(max:error)
+  for(size_t i = 0; i < n; i++){
+    float f = (float) in[i];
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    bits += 0x7fff + ((bits >> 16) & 1);
+    out[i] = (uint16_t) (bits >> 16);
+    uint32_t wide = (uint32_t) out[i] << 16;
+    memcpy(&f, &wide, sizeof(f));
+    error = std::max(error, fabs(in[i] - (double) f));
+  }
+  return error;
+}
+
+inline void codec_widen_bfloat16(const uint16_t *in, size_t n, double *out){
+  #pragma omp simd
+  for(size_t i = 0; i < n; i++){
+    uint32_t wide = (uint32_t) in[i] << 16;
+    float f;
+    memcpy(&f, &wide, sizeof(f));
+    out[i] = f;
+  }
+}
+
+/*
+ * Packs n doubles into out, which must hold codec_bound(n) bytes, and returns
+ * the packed size. error is set to the largest difference from a value as
+ * it was sent. Quantising falls back to lossless compression for values it
+ * can not bound, infinities and NaNs or a range too wide for 32 bit codes.
+ * Narrowing does not check for values beyond the range of a float.
+ */
+inline size_t codec_encode(int codec, double error_bound, const double *in, size_t n, unsigned char *out, double *error){
+  memset(out, 0, CODEC_HEADER);
+  uint64_t count = n;
+  memcpy(out + 8, &count, sizeof(count));
+  unsigned char *payload = out + CODEC_HEADER;
+  size_t bytes = 0;
+  out[1] = sizeof(double);
+  *error = 0.0;
+  if(n == 0){
+    return CODEC_HEADER;
+  }
+  if(codec == CODEC_FLOAT){
+    out[0] = CODEC_STORED_FLOAT;
+    out[1] = sizeof(float);
+    *error = codec_narrow_float(in, n, (float *) payload);
+    return codec_header_size(out, n * sizeof(float));
+  }
+  if(codec == CODEC_BFLOAT16){
+    out[0] = CODEC_STORED_BFLOAT16;
+    out[1] = sizeof(uint16_t);
+    *error = codec_narrow_bfloat16(in, n, (uint16_t *) payload);
+    return codec_header_size(out, n * sizeof(uint16_t));
+  }
+  if(codec == CODEC_QUANTISE && error_bound > 0.0 && n > 0){
+    double low = in[0], high = in[0];
+    bool finite = true;
+    for(size_t i = 0; i < n; i++){
+      finite = finite && std::isfinite(in[i]);
+      low = std::min(low, in[i]);
+      high = std::max(high, in[i]);
+    }
+    //a step just under twice the bound keeps rounding within it
+    double step = 2.0 * error_bound * (1.0 - 1e-9);
+    double levels = finite ? (high - low) / step : INFINITY;
+    if(levels < 4294967295.0){
+      int width = (levels < 255.0) ? 1 : ((levels < 65535.0) ? 2 : 4);
+      std::vector<unsigned char> codes(n * width);
+      for(size_t i = 0; i < n; i++){
+        uint32_t code = (uint32_t) llround((in[i] - low) / step);
+        memcpy(&codes[i * width], &code, width);//little endian, so the low bytes
+        *error = std::max(*error, fabs(in[i] - (low + code * step)));
+      }
+      bytes = codec_planes(codes.data(), n, width, payload);
+      if(bytes > 0){
+        out[0] = CODEC_STORED_QUANTISED;
+        out[1] = width;
+        memcpy(out + 16, &low, sizeof(low));
+        memcpy(out + 24, &step, sizeof(step));
+        return codec_header_size(out, bytes);
+      }
+    }
+  }
+  if(codec != CODEC_RAW){
+    bytes = codec_planes((const unsigned char *) in, n, sizeof(double), payload);
+    if(bytes > 0){
+      out[0] = CODEC_STORED_LZ;
+      out[1] = sizeof(double);
+      return codec_header_size(out, bytes);
+    }
+  }
+  out[0] = CODEC_STORED_RAW;
+  out[1] = sizeof(double);
+  memcpy(payload, in, n * sizeof(double));
+  return codec_header_size(out, n * sizeof(double));
+}
+
+//bytes of the packed message in starts with
+inline size_t codec_size(const unsigned char *in){
+  uint32_t payload_bytes;
+  memcpy(&payload_bytes, in + 4, sizeof(payload_bytes));
+  return CODEC_HEADER + payload_bytes;
+}
+
+//values the packed message in holds
+inline size_t codec_count(const unsigned char *in){
+  uint64_t count;
+  memcpy(&count, in + 8, sizeof(count));
+  return count;
+}
+
+/*
+ * Unpacks a message of n doubles into out. scratch must hold n doubles and
+ * is only used by the LZ compressed payloads, so callers can keep it from one
+ * message to the next. A message packed from some other number of values
+ * would be read or written out of bounds, so it aborts.
+ */
+inline void codec_decode(const unsigned char *in, double *out, size_t n, unsigned char *scratch){
+  const unsigned char *payload = in + CODEC_HEADER;
+  size_t payload_bytes = codec_size(in) - CODEC_HEADER;
+  int width = in[1];
+  if(codec_count(in) != n){
+    fprintf(stderr, "Error: packed message holds %zu values but %zu were expected, aborting...\n", codec_count(in), n);
+    exit(1);
+  }
+  if(n == 0){
+    return;
+  }
+  if(in[0] == CODEC_STORED_RAW){
+    memcpy(out, payload, n * sizeof(double));
+    return;
+  }
+  if(in[0] == CODEC_STORED_FLOAT){
+    codec_widen_float((const float *) payload, n, out);
+    return;
+  }
+  if(in[0] == CODEC_STORED_BFLOAT16){
+    codec_widen_bfloat16((const uint16_t *) payload, n, out);
+    return;
+  }
+  codec_lz_decompress(payload, payload_bytes, scratch, n * width);
+  if(in[0] == CODEC_STORED_LZ){
+    codec_unshuffle(scratch, n, width, (unsigned char *) out);
+    return;
+  }
+  //the quantised codes are read straight from their byte planes
+  double low, step;
+  memcpy(&low, in + 16, sizeof(low));
+  memcpy(&step, in + 24, sizeof(step));
+  for(size_t i = 0; i < n; i++){
+    uint32_t code = 0;
+    for(int b = 0; b < width; b++){
+      code |= (uint32_t) scratch[b * n + i] << (8 * b);
+    }
+    out[i] = low + code * step;
+  }
+}
+#endif
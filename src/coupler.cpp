@@ -19,17 +19,39 @@
 #include <iterator>
 #include <iostream>
 #include <chrono>
-#include <map>
-
-int main(int argc, char** argv){
-	#include "coupler_config.h"
-	FILE *ifp = fopen("cpx_input.cfg", "r");
+#include "kdtree.h"
+#include "interface.h"
+#include "interpolation.h"
+#include "redistribution.h"
+#include "arena.h"
+#include "input_decks.h"
+#include "placement.h"
+#include "perf_model.h"
+#include "trace.h"
+#include "codec.h"
+
+//world ranks of a unit
+std::vector<int> unit_ranks(const struct unit &u, const std::vector<int> &layout){
+	std::vector<int> ranks(u.processes);
+	for(int i = 0; i < u.processes; i++){
+		ranks[i] = placement_rank(layout, u.first_rank + i);
+	}
+	return ranks;
+}
 
-	if(ifp == NULL){
-		fprintf(stderr, "Can't open input file cpx_input.cfg\n");
-		exit(1);
+//number of coupler units that exchange data with unit u
+int unit_couplers(const std::vector<struct unit> &units, int u){
+	int count = 0;
+	for(int i = 0; i < (int) units.size(); i++){
+		if(units[i].type == 'C' && (units[i].mgcfd_units[0] == u + 1 || units[i].mgcfd_units[1] == u + 1)){
+			count++;
+		}
 	}
+	return count;
+}
 
+//fills units from a cpx_input.cfg style file, exits on anything malformed
+void read_cpx_input(const char *file_name, std::vector<struct unit> &units){
 	char coupler[] = "COUPLER";
 	char mgcfd[] = "MG-CFD";
 	char fenics[] = "FENICS";
@@ -38,23 +60,25 @@ int main(int argc, char** argv){
 	char unit_2[] = "UNIT_2";
 	char total[] = "TOTAL";
 	char type[] = "TYPE";
-	int mpi_ranks = 0;
 	char keyword[8];//longest word is COUPLER
 	char c_type[8]; //longest type is sliding
 	int temp_unit;//temporarily stores how many processes each unit will have
 	int num_of_units = 0;//number of coupler units as read from the TOTAL value
 	int temp_count = 0;//used to count the total number of units and verify it matches the TOTAL value
-	int coupler_count = 0;//used to count total number of coupler units
-	int mgcfd_count = 0;//used to count total umber of MG-CFD units
-	int fenics_count = 0;//used to count the number of FENICS units
-	int simpic_count = 0;//used to count the number of CUP-CFD units
+
+	FILE *ifp = fopen(file_name, "r");
+
+	if(ifp == NULL){
+		fprintf(stderr, "Can't open input file %s\n", file_name);
+		exit(1);
+	}
 
 	fscanf(ifp, "%s %d", keyword, &temp_unit);
 	if(strcmp(keyword, total) == 0){
 		num_of_units = temp_unit;
 	}
 
-	struct unit units[num_of_units];//creates AoS for either coupler unit or MG-CFD unit
+	units.resize(num_of_units);
 
 	while(fscanf(ifp, "%s %d", keyword, &temp_unit) != EOF){//filling the AoS with unit information
 		if(strcmp(keyword, coupler) == 0){
@@ -76,14 +100,10 @@ int main(int argc, char** argv){
 				exit(1);
 			}
 			temp_count++;
-			coupler_count++;
-			mpi_ranks += temp_unit;
 		}else if(strcmp(keyword, mgcfd) == 0){
 			units[temp_count].type = 'M';
 			units[temp_count].processes = temp_unit;
 			temp_count++;
-			mgcfd_count++;
-			mpi_ranks += temp_unit;
 		}else if(strcmp(keyword, fenics) == 0){
 			#ifndef deffenics
 				fprintf(stderr, "Error: CPX has not been compiled with FEniCS X support.\n");
@@ -92,8 +112,6 @@ int main(int argc, char** argv){
 			units[temp_count].type = 'F';
 			units[temp_count].processes = temp_unit;
 			temp_count++;
-			fenics_count++;
-			mpi_ranks += temp_unit;
 		}else if(strcmp(keyword, simpic) == 0){
 			#ifndef defsimpic
 				fprintf(stderr, "Error: CPX has not been compiled with SIMPIC support.\n");
@@ -102,8 +120,6 @@ int main(int argc, char** argv){
 			units[temp_count].type = 'P';
 			units[temp_count].processes = temp_unit;
 			temp_count++;
-			simpic_count++;
-			mpi_ranks += temp_unit;
 		}else if(strcmp(keyword, unit_1) == 0 || strcmp(keyword, unit_2) == 0){
 			units[temp_count-1].mgcfd_units.push_back(temp_unit);
 		}
@@ -114,13 +130,89 @@ int main(int argc, char** argv){
 	}
 
 	fclose(ifp);
-  MPI_Init(&argc, &argv);
+}
+
+//writes units out in the format read_cpx_input reads
+bool write_cpx_input(const char *file_name, const std::vector<struct unit> &units){
+	FILE *ofp = fopen(file_name, "w");
+	if(ofp == NULL){
+		fprintf(stderr, "Can't open output file %s\n", file_name);
+		return false;
+	}
+	fprintf(ofp, "TOTAL %zu\n\n", units.size());
+	for(int i = 0; i < (int) units.size(); i++){
+		if(units[i].type == 'C'){
+			const char *c_type = (units[i].coupling_type == 'S') ? "SLIDING" : ((units[i].coupling_type == 'C') ? "CHT" : "OVERSET");
+			fprintf(ofp, "\nCOUPLER %d\nTYPE %s\nUNIT_1 %d\nUNIT_2 %d\n", units[i].processes, c_type, units[i].mgcfd_units[0], units[i].mgcfd_units[1]);
+		}else{
+			const char *name = (units[i].type == 'M') ? "MG-CFD" : ((units[i].type == 'F') ? "FENICS" : "SIMPIC");
+			fprintf(ofp, "%s %d\n", name, units[i].processes);
+		}
+	}
+	fclose(ofp);
+	return true;
+}
 
-  int rank, size;
+int main(int argc, char** argv){
+	#include "coupler_config.h"
+	MPI_Init(&argc, &argv);
+
+	int rank, size;
 
-  //get initial ranks
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+	//get initial ranks
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	//cpx --predict <cfg> models a run of the given configuration from the calibration data instead of running it
+	if(argc > 2 && strcmp(argv[1], "--predict") == 0){
+		if(rank == 0){
+			std::vector<struct unit> target;
+			read_cpx_input(argv[2], target);
+			perf_model_report(target, coupler_cycles, search_freq, coupling_staleness > 0);
+		}
+		MPI_Finalize();
+		return 0;
+	}
+	//cpx --allocate <ranks> <cfg> [out] shares the ranks out between the units of cfg and writes the result to out, cpx_input.cfg by default
+	if(argc > 3 && strcmp(argv[1], "--allocate") == 0){
+		if(rank == 0){
+			std::vector<struct unit> allocated;
+			read_cpx_input(argv[3], allocated);
+			const char *out = (argc > 4) ? argv[4] : "cpx_input.cfg";
+			if(perf_model_allocate(allocated, atoi(argv[2]), coupler_cycles, search_freq, coupling_staleness > 0) && write_cpx_input(out, allocated)){
+				printf("Written to %s\n", out);
+			}
+		}
+		MPI_Finalize();
+		return 0;
+	}
+
+	int mpi_ranks = 0;
+	int num_of_units = 0;//number of coupler units as read from the TOTAL value
+	int coupler_count = 0;//used to count total number of coupler units
+	int mgcfd_count = 0;//used to count total umber of MG-CFD units
+	int fenics_count = 0;//used to count the number of FENICS units
+	int simpic_count = 0;//used to count the number of CUP-CFD units
+
+	std::vector<struct unit> units;//creates AoS for either coupler unit or MG-CFD unit
+	struct input_decks decks;
+
+	//only rank 0 touches the input decks, the other ranks are sent what they need
+	if(rank == 0){
+		read_cpx_input("cpx_input.cfg", units);
+		for(int i = 0; i < (int) units.size(); i++){
+			coupler_count += (units[i].type == 'C');
+			mgcfd_count += (units[i].type == 'M');
+			fenics_count += (units[i].type == 'F');
+			simpic_count += (units[i].type == 'P');
+		}
+		input_decks_load(&decks);
+	}
+	input_decks_bcast_units(units);
+	num_of_units = units.size();
+	for(int i = 0; i < num_of_units; i++){
+		mpi_ranks += units[i].processes;
+	}
 
   if(rank == 0){
     printf("It's coupler time ;)");
@@ -139,165 +231,103 @@ int main(int argc, char** argv){
 			}
 		}
 
-    if(mpi_ranks != size){
-    	fprintf(stderr, "Error: there is a mismatch in the number requested MPI ranks and the number of ranks requested in the config file.\n");
-      exit(1);
-	  }
+  }
+  if(mpi_ranks != size){
+    if(rank == 0){
+      fprintf(stderr, "Error: there is a mismatch in the number requested MPI ranks and the number of ranks requested in the config file.\n");
+    }
+    exit(1);
   }
 
-	struct locators relative_positions[mpi_ranks];//creates AoS with an entry for every process
-
+	//units take consecutive blocks of the rank layout in the order they are listed, so a prefix sum over their sizes places every rank
+	int my_unit = 0;
+	int temp_marker = 0;//to mark where in the rank layout we are
 	int temp_coupler = 0;
-	int temp_marker = 0;//to mark where in the relative_positions array we are
 	int temp_work = 0;
-
-	std::vector<int> temp_coupler_position;
-	std::vector<int> temp_work_position;
-
+	std::vector<int> places(num_of_units);//e.g 1 for 1st coupler/work unit, 2 for 2nd coupler/work unit
 	for(int i=0; i<num_of_units;i++){
-		if(units[i].type != 'C'){
-			temp_work++;
-			temp_work_position.push_back(temp_work);
-			for(int j=temp_marker; j < temp_marker + units[i].processes; j++){
-				relative_positions[j].typelocator = units[i].type;
-				relative_positions[j].placelocator = temp_work;
-			}
-			temp_marker += units[i].processes;
-		}       
+		units[i].first_rank = temp_marker;
 		if(units[i].type == 'C'){
 			temp_coupler++;
-			temp_coupler_position.push_back(temp_coupler);
-			for(int j=temp_marker; j < temp_marker + units[i].processes; j++){
-				relative_positions[j].typelocator = 'C';
-				relative_positions[j].placelocator = temp_coupler;
-			}
-			temp_marker += units[i].processes;
-
-			std::vector<int> temp_coupler_processes;//stores the process list to go into the units[k].coupler_ranks vector
-			int temp_coupler_relative_position = temp_coupler_position.back();//the placelocator for the coupler unit
-			temp_coupler_position.pop_back();
-			for(int j=0; j<temp_marker; j++){
-				if(relative_positions[j].placelocator == temp_coupler_relative_position && relative_positions[j].typelocator == 'C'){
-					temp_coupler_processes.push_back(j);//add coupler ranks to the temp_coupler_processes vector to transfer to the units[k].coupler_ranks
-				}
-			}
-			units[i].coupler_ranks.push_back(temp_coupler_processes);
-
-			int k2 = units[i].mgcfd_units[0] - 1;//keep k to store the mgcfd processes in the coupler unit 'mgcfd_ranks' vector
-
-
-			units[k2].coupler_ranks.push_back(temp_coupler_processes);
+			places[i] = temp_coupler;
+		}else{
+			temp_work++;
+			places[i] = temp_work;
+		}
+		temp_marker += units[i].processes;
+	}
 
+	//world rank at each position of the layout, empty unless the ranks are placed by node
+	std::vector<int> layout;
+	if(topology_placement){
+		placement_layout(units, mxn_redistribution, layout);
+	}
+	int position = placement_position(layout, rank);
+	for(int i=0; i<num_of_units;i++){
+		if(position >= units[i].first_rank && position < units[i].first_rank + units[i].processes){
+			my_unit = i;
+		}
+	}
 
-			std::vector<int> temp_mgcfd_processes;
-			for(int j=0; j<temp_marker; j++){
-				if(relative_positions[j].placelocator == (k2 + 1) && relative_positions[j].typelocator != 'C'){
-                    temp_mgcfd_processes.push_back(j);//add mgcfd ranks to the temp_mgcfd_processes vector to transfer to the units[k & k2].coupler_ranks
-				}
+	//rank lists are only filled in for this rank's own unit and the units it exchanges data with
+	for(int i=0; i<num_of_units;i++){
+		if(units[i].type == 'C'){
+			int k2 = units[i].mgcfd_units[0] - 1;//the two units this coupler unit manages
+			int k3 = units[i].mgcfd_units[1] - 1;
+			if(my_unit == i || my_unit == k2 || my_unit == k3){
+				units[i].coupler_ranks.push_back(unit_ranks(units[i], layout));
+				units[i].mgcfd_ranks.push_back(unit_ranks(units[k2], layout));
+				units[i].mgcfd_ranks.push_back(unit_ranks(units[k3], layout));
 			}
-
-			units[i].mgcfd_ranks.push_back(temp_mgcfd_processes);//set mgcfd_ranks of the coupler unit to the discovered ranks
-			units[k2].mgcfd_ranks.push_back(temp_mgcfd_processes);//set mgcfd_ranks of the 1st MG-CFD unit to the discovered ranks
-
-			int k3 = units[i].mgcfd_units[1] - 1;//k3 is the 2nd MGCFD instance that the coupler unit manages
-
-			units[k3].coupler_ranks.push_back(temp_coupler_processes);
-
-
-			temp_mgcfd_processes.clear();
-			for(int j=0; j<temp_marker; j++){
-				if(relative_positions[j].placelocator == (k3 + 1) && relative_positions[j].typelocator != 'C'){
-					temp_mgcfd_processes.push_back(j);//add coupler ranks to the temp_coupler_processes vector to transfer to the units[k & k3].coupler_ranks
-				}
+			if(my_unit == k2 || my_unit == k3){
+				units[my_unit].coupler_ranks.push_back(units[i].coupler_ranks[0]);
+				units[my_unit].coupler_units.push_back(i);
 			}
-
-			units[i].mgcfd_ranks.push_back(temp_mgcfd_processes);//set mgcfd_ranks of the coupler unit to the discovered ranks
-			units[k3].mgcfd_ranks.push_back(temp_mgcfd_processes);//set mgcfd_ranks of the 2nd MG-CFD unit to the discovered ranks
 		}
 	}
+	if(units[my_unit].type != 'C'){
+		units[my_unit].mgcfd_ranks.push_back(unit_ranks(units[my_unit], layout));
+	}
 
 	//for debugging purposes
 	if(rank == 0 && debug == true){
-		for(int i = 0; i<mpi_ranks; i++){
-			printf("\n\nRank %d\n", i);
-			printf("Type: %c\n",relative_positions[i].typelocator);
-			printf("Place: %d\n",relative_positions[i].placelocator);
-		}
 		for(int i = 0; i<num_of_units; i++){
 			printf("\n\nType %c\n", units[i].type);
-            if(units[i].coupler_ranks.size() != 0){
-			    int no_of_elements_coupler = units[i].coupler_ranks[0].size();
-			    for(int j = 0; j < no_of_elements_coupler; j++){
-				    printf("Coupler ranks: %d\n", units[i].coupler_ranks[0][j]);
-			    }
-            }
-			int no_of_elements = units[i].mgcfd_ranks[0].size();
-			for(int j = 0; j < no_of_elements; j++){
-			    printf("Unit Ranks: %d\n", units[i].mgcfd_ranks[0][j]);
-			    if(units[i].type == 'C'){
-				    printf("Unit Ranks: %d\n", units[i].mgcfd_ranks[1][j]);
-			    }
-            }
+			printf("Place: %d\n", places[i]);
+			for(int j = units[i].first_rank; j < units[i].first_rank + units[i].processes; j++){
+				printf("Unit Ranks: %d\n", placement_rank(layout, j));
+			}
 		}
 	}
-	MPI_Group world_group;
-	MPI_Comm_group(MPI_COMM_WORLD, &world_group);
 
-	MPI_Group new_groups[num_of_units];
-	MPI_Comm new_comms[num_of_units];
+	//one split gives every unit its communicator, ordered as in the layout
 	MPI_Comm new_comm;
-	bool is_coupler = false;
-	bool is_mgcfd = false;
-	bool is_fenics = false;
-	int instance_number = 0;
-
+	MPI_Comm_split(MPI_COMM_WORLD, my_unit, position, &new_comm);
+	bool is_coupler = (units[my_unit].type == 'C');
+	bool is_mgcfd = (units[my_unit].type == 'M');
+	bool is_fenics = (units[my_unit].type == 'F');
+	int instance_number = places[my_unit];
+	std::vector<int> unit_roots(num_of_units);
 	for(int i=0; i<num_of_units;i++){
-		if(units[i].type == 'C'){
-			int ranks[units[i].coupler_ranks[0].size()];
-			std::copy(units[i].coupler_ranks[0].begin(), units[i].coupler_ranks[0].end(), ranks);
-			MPI_Group_incl(world_group, units[i].coupler_ranks[0].size(), ranks, &new_groups[i]);
-			MPI_Comm_create_group(MPI_COMM_WORLD, new_groups[i], 0, &new_comms[i]);
-			for(int j=units[i].coupler_ranks[0][0]; j<units[i].coupler_ranks[0][0]+units[i].coupler_ranks[0].size();j++){//if rank of processes matches a rank for a particular coupler unit, assign the new communicator
-				if(rank == j){
-					new_comm=new_comms[i];
-					is_coupler = true;
-					instance_number = relative_positions[rank].placelocator;
-				}
-			}
-		}
-		if(units[i].type != 'C'){
-			int ranks[units[i].mgcfd_ranks[0].size()];
-			std::copy(units[i].mgcfd_ranks[0].begin(), units[i].mgcfd_ranks[0].end(), ranks);
-			MPI_Group_incl(world_group, units[i].mgcfd_ranks[0].size(), ranks, &new_groups[i]);
-			MPI_Comm_create_group(MPI_COMM_WORLD, new_groups[i], 0, &new_comms[i]);
-			for(int j=units[i].mgcfd_ranks[0][0]; j<units[i].mgcfd_ranks[0][0]+units[i].mgcfd_ranks[0].size();j++){//if rank of processes matches a rank for a particular MG-CFD unit, assign the new communicator
-				if(rank == j){
-					new_comm=new_comms[i];
-					if(units[i].type == 'M'){
-						is_mgcfd = true;
-					} else if(units[i].type == 'F'){
-						is_fenics = true;
-					}
-					instance_number = relative_positions[rank].placelocator;
-				}
-			}
-		}
+		unit_roots[i] = placement_rank(layout, units[i].first_rank);
 	}
+	input_decks_distribute(&decks, units.data(), num_of_units, my_unit, unit_roots.data(), new_comm);
+
     MPI_Fint comms_shell = MPI_Comm_c2f(new_comm);
 	//end of the set up we then call mgcfd main or fenics main if its not a coupler.
 	if(!is_coupler){
 		if(is_mgcfd){
-            main_mgcfd(argc, argv, comms_shell, instance_number, units, relative_positions);
+            main_mgcfd(argc, argv, comms_shell, instance_number, units.data(), &decks);
 		}else if(is_fenics){
 			#ifdef deffenics
-                main_dolfinx(argc, argv, comms_shell, instance_number, units, relative_positions);
+                main_dolfinx(argc, argv, comms_shell, instance_number, units.data(), &decks);
 			#endif
             MPI_Finalize();
 		}else{
 			#ifdef defsimpic
 				//printf("launch simpic here");
-				main_simpic(argc, argv, comms_shell, instance_number, units, relative_positions);
-				//main_cup(argc, argv, comms_shell, instance_number, units, relative_positions);
+				main_simpic(argc, argv, comms_shell, instance_number, units.data(), &decks);
+				//main_cup(argc, argv, comms_shell, instance_number, units.data(), &decks);
             #endif
 			MPI_Finalize();
 		}
@@ -305,6 +335,10 @@ int main(int argc, char** argv){
 		if(superdebug){
 			#ifdef defsimpic
 			#endif
+			//nothing to record, but rank 0 still waits for every unit's part of the trace
+			struct trace timeline;
+			trace_init(&timeline, trace_timeline, "Coupler " + std::to_string(instance_number), my_unit, 0);
+			trace_write(&timeline, new_comm);
 			MPI_Finalize();
 			
 		}else{
@@ -312,19 +346,10 @@ int main(int argc, char** argv){
 
 			int my_rank;
 	  		MPI_Comm_rank(coupler_comm, &my_rank);
+			struct trace timeline;
+			trace_init(&timeline, trace_timeline, "Coupler " + std::to_string(instance_number), my_unit, my_rank);
 
-			bool found = false;
-			int unit_count = 0;
-	    	while(!found){
-				for(int j=units[unit_count].coupler_ranks[0][0]; j<units[unit_count].coupler_ranks[0][0]+units[unit_count].coupler_ranks[0].size();j++){//if rank of processes matches a rank for a particular coupler unit, assign the new communicator
-					if(units[unit_count].type == 'C' && rank == j){
-						found=true;
-					}
-				}
-	            if(found == false){
-	                unit_count++;
-	            }
-	    	}
+			int unit_count = my_unit;
 			
 			int left_rank = units[unit_count].mgcfd_ranks[0][0];
 			int right_rank = units[unit_count].mgcfd_ranks[1][0];
@@ -332,8 +357,18 @@ int main(int argc, char** argv){
 	        double left_nodes_size = 0.0;
 	        double right_nodes_size = 0.0;
  
-	        MPI_Recv(&left_nodes_size, 1, MPI_DOUBLE, left_rank, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-	        MPI_Recv(&right_nodes_size, 1, MPI_DOUBLE, right_rank, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+	        MPI_Request recv_requests[2];
+ 
+	        MPI_Irecv(&left_nodes_size, 1, MPI_DOUBLE, left_rank, MPI_ANY_TAG, MPI_COMM_WORLD, &recv_requests[0]);
+	        MPI_Irecv(&right_nodes_size, 1, MPI_DOUBLE, right_rank, MPI_ANY_TAG, MPI_COMM_WORLD, &recv_requests[1]);
+	        MPI_Waitall(2, recv_requests, MPI_STATUSES_IGNORE);
+
+			if(mxn_redistribution && rank == units[unit_count].coupler_ranks[0][0]){
+				//each unit needs both interface sizes to work out which coupler ranks its pieces go to
+				double interface_sizes[2] = {left_nodes_size, right_nodes_size};
+				MPI_Send(interface_sizes, 2, MPI_DOUBLE, left_rank, 0, MPI_COMM_WORLD);
+				MPI_Send(interface_sizes, 2, MPI_DOUBLE, right_rank, 0, MPI_COMM_WORLD);
+			}
 
 			int left_right_size = (int) ((left_nodes_size + right_nodes_size)/2);
 
@@ -344,25 +379,20 @@ int main(int argc, char** argv){
 			double left_search_scaling = 0;
 			double right_search_scaling = 0;
 			double search_repeats;
-            double interp_scaling;
 			if(ultrafastsearch){
 				search_repeats = 0.25;
-				interp_scaling = 90;
 			}else{
 				search_repeats = 10;
-				interp_scaling = 3500;
 			}
 			
             int coupler_vars = 0;
             if(units[unit_count].coupling_type == 'S'){
                 left_search_scaling = search_repeats * adjusted_sizes_left;
                 right_search_scaling = search_repeats * adjusted_sizes_right;
-                //interp_scaling = 3500/((adjusted_sizes_left + adjusted_sizes_right)/2);
                 coupler_vars = 5;
             }else if(units[unit_count].coupling_type == 'O'){
 				left_search_scaling = search_repeats * adjusted_sizes_left;
                 right_search_scaling = search_repeats * adjusted_sizes_right;
-                //interp_scaling = 3500/((adjusted_sizes_left + adjusted_sizes_right)/2);
                 coupler_vars = 1;
 			}else if(units[unit_count].coupling_type == 'C'){
                 left_search_scaling = 3;
@@ -370,296 +400,450 @@ int main(int argc, char** argv){
                 coupler_vars = 1;
             }
 
-	        double *left_p_variables_recv = (double *) malloc(left_nodes_size * coupler_vars * sizeof(double));
-	        double *right_p_variables_recv = (double *) malloc(right_nodes_size * coupler_vars * sizeof(double));
-			double *left_p_variables = (double *) malloc(left_right_size * coupler_vars * sizeof(double));
-			double *right_p_variables = (double *) malloc(left_right_size * coupler_vars * sizeof(double));
-
 			int total_ranks = units[unit_count].coupler_ranks[0].size();
 			int root_rank = units[unit_count].coupler_ranks[0][0];
 
-			double left_right_size_chunks = left_right_size / total_ranks;
-
-			double vector_counter;
-			int sub_count;
-			double vector_counter_max;
+			//nodes of the left and right arrays held by each coupler rank, and the same in doubles for the v collectives
+			std::vector<int> chunk_counts;
+			std::vector<int> chunk_displs;
+			std::vector<int> sg_counts(total_ranks);
+			std::vector<int> sg_displs(total_ranks);
+			redistribution_partition(left_right_size, total_ranks, chunk_counts, chunk_displs);
+			for(int c = 0; c < total_ranks; c++){
+				sg_counts[c] = chunk_counts[c] * coupler_vars;
+				sg_displs[c] = chunk_displs[c] * coupler_vars;
+			}
+			int left_right_size_chunks = chunk_counts[my_rank];
+			//a rebalance may at most double the balanced share, which bounds the scatter/gather buffers
+			int max_chunk = mxn_redistribution ? left_right_size_chunks : std::min(left_right_size, 2 * ((left_right_size + total_ranks - 1) / total_ranks));
+			std::chrono::duration<double> partition_cost = std::chrono::duration<double>::zero();//search and interpolation time on this rank since the last rebalance
+
+			//pieces exchanged directly with the unit ranks when the roots are bypassed, otherwise the root's whole interfaces
+			bool funnel_root = (rank == root_rank && !mxn_redistribution);
+			struct redistribution exchange;
+			bool shared_side[2] = {false, false};
+			if(mxn_redistribution){
+				redistribution_coupler_schedule(&exchange, units[unit_count].mgcfd_ranks[0], units[unit_count].mgcfd_ranks[1], left_nodes_size, right_nodes_size, my_rank, total_ranks, coupler_vars);
+			}else if(funnel_root){
+				redistribution_root_schedule(&exchange, left_rank, left_nodes_size, right_rank, right_nodes_size, coupler_vars);
+				//a unit that only talks to this coupler can lend us its interface in place if it never sends ahead of its reply, or expose it for us to get and put
+				for(int side = 0; side < 2; side++){
+					int u = units[unit_count].mgcfd_units[side] - 1;
+					if(units[u].type == 'P' || unit_couplers(units, u) != 1){
+						continue;
+					}
+					if(shared_memory_transport && coupling_staleness == 0){
+						shared_side[side] = redistribution_share(&exchange, side, false, 0);
+					}
+					if(one_sided_transport && !shared_side[side]){
+						redistribution_expose(&exchange, side, false, 0);
+					}
+				}
+			}
 
-			//p_variables storage for scatter/gather
-			double *left_p_variables_sg = (double *) malloc((left_right_size_chunks) * coupler_vars * sizeof(double));
-	        double *right_p_variables_sg = (double *) malloc((left_right_size_chunks) * coupler_vars * sizeof(double));
+			//work arrays, all carved out of one arena; the whole interface is only held where it is reordered or needed in full
+			bool full_interface = (funnel_root || MUM == 0);
+			int ar_size_max = left_right_size*0.9;
+			int quad_size = ceil(ar_size_max*0.7);
+			bool cht = (units[unit_count].coupling_type == 'C');
+			double *left_p_variables_recv;
+			double *right_p_variables_recv;
+			double *left_p_variables;
+			double *right_p_variables;
+			double *left_p_variables_sg;//p_variables storage for scatter/gather
+			double *right_p_variables_sg;
+			double *data_ran_storage;
+			double *quad_array_rt;
+			double *quad_array_lt;
+			struct arena_request work_requests[] = {
+				{&left_p_variables_recv, (funnel_root && !shared_side[0]) ? (size_t) left_nodes_size * coupler_vars : 0},
+				{&right_p_variables_recv, (funnel_root && !shared_side[1]) ? (size_t) right_nodes_size * coupler_vars : 0},
+				{&left_p_variables, full_interface ? (size_t) left_right_size * coupler_vars : 0},
+				{&right_p_variables, full_interface ? (size_t) left_right_size * coupler_vars : 0},
+				{&left_p_variables_sg, (size_t) max_chunk * coupler_vars},
+				{&right_p_variables_sg, (size_t) max_chunk * coupler_vars},
+				{&data_ran_storage, cht ? (size_t) ar_size_max * 4 : 0},
+				{&quad_array_rt, cht ? (size_t) quad_size : 0},
+				{&quad_array_lt, cht ? (size_t) quad_size : 0}
+			};
+			struct arena work;
+			arena_setup(&work, work_requests, sizeof(work_requests) / sizeof(work_requests[0]));
+			double (*data_ran)[4] = (double (*)[4]) data_ran_storage;
+			//a shared interface is read where the unit wrote it
+			if(shared_side[0]){
+				left_p_variables_recv = exchange.pieces[0].shared_recv;
+			}
+			if(shared_side[1]){
+				right_p_variables_recv = exchange.pieces[1].shared_recv;
+			}
 
-			//p_variable vectors to represent brute force search
-			std::vector< std::vector<double> > left_vector_of_state_vars;
-			std::vector< std::vector<double> > right_vector_of_state_vars;
+			//every message piece is packed with the codec chosen for this coupler type, which the units choose as well
+			int codec = codec_select(units[unit_count].coupling_type, sliding_codec, overset_codec, cht_codec);
+			if(mxn_redistribution || funnel_root){
+				redistribution_compress(&exchange, codec, codec_error_bound);
+			}
+			if(mxn_redistribution){
+				redistribution_bind(&exchange, left_p_variables_sg, right_p_variables_sg, left_p_variables_sg, right_p_variables_sg);
+			}else if(funnel_root){
+				redistribution_bind(&exchange, left_p_variables_recv, right_p_variables_recv, left_p_variables_recv, right_p_variables_recv);
+			}
 
-			//p_variable vectors to represent tree-based search
-			std::map< int, std::vector<double> > left_map_of_state_vars;
-			std::map< int, std::vector<double> > right_map_of_state_vars;
+			//flat per-variable copies of the interface state and the interpolated result
+			struct interface_buffer left_state;
+			struct interface_buffer right_state;
+			struct interface_buffer left_interp;
+			struct interface_buffer right_interp;
+
+			//interface geometry and donor maps produced by the rendezvous search
+			int search_size = (MUM == 0) ? left_right_size : (int) left_right_size_chunks;
+			long long search_offset = (MUM == 0) ? 0 : chunk_displs[my_rank];
+			//everything sized by search_size is allocated for the largest chunk a rebalance may give, so a rebalance only changes sizes
+			int search_capacity = (MUM == 0) ? left_right_size : max_chunk;
+			std::vector<double3> left_coords(search_size);
+			std::vector<double3> right_coords(search_size);
+			left_coords.reserve(search_capacity);
+			right_coords.reserve(search_capacity);
+			struct csr_operator right_to_left;//interpolates right side state onto the left nodes
+			struct csr_operator left_to_right;//interpolates left side state onto the right nodes
+			std::vector<int> donor_ids(interp_donors);
+			std::vector<double> donor_dist2(interp_donors);
+			struct kdtree left_tree;
+			struct kdtree right_tree;
+
+			interface_buffer_alloc(&left_state, search_size, coupler_vars, search_capacity);
+			interface_buffer_alloc(&right_state, search_size, coupler_vars, search_capacity);
+			interface_buffer_alloc(&left_interp, search_size, coupler_vars, search_capacity);
+			interface_buffer_alloc(&right_interp, search_size, coupler_vars, search_capacity);
+			csr_begin(&right_to_left, search_capacity, interp_donors);
+			csr_begin(&left_to_right, search_capacity, interp_donors);
+			if(fastsearch){
+				kdtree_reserve(&left_tree, search_capacity);
+				kdtree_reserve(&right_tree, search_capacity);
+			}
 
-			std::vector<double> node_state_vars;
-			std::vector<double> node_state_vars_left;
-			std::vector<double> node_state_vars_right;
-			std::vector<double> node_state_vars_temp;
+			//nodes of the state buffers this rank interpolates, all of them unless every rank holds the whole interface
+			int interp_begin = (MUM == 0) ? chunk_displs[my_rank] : 0;
+			int interp_end = interp_begin + left_right_size_chunks;
 
 			//set up some random data for cht interpolation
-			int ar_size_max = left_right_size*0.9;
 			if(rank == root_rank && debug == true){
 				printf("size is %d\n", ar_size_max);
 			}
-			srand((unsigned)time(NULL));
-			double data_ran[ar_size_max][4];
-			for(int i = 0; i < ar_size_max; i++){
-				for(int k = 0; k < 4; k++){
-					data_ran[i][k] = rand()/1000;
+			if(cht){
+				srand((unsigned)time(NULL));
+				for(int i = 0; i < ar_size_max; i++){
+					for(int k = 0; k < 4; k++){
+						data_ran[i][k] = rand()/1000;
+					}
 				}
 			}
 			
-			std::chrono::duration<double> total_seconds;
-			std::chrono::duration<double> non_coupling_secs;
-			std::chrono::duration<double> pure_compute_sec;
-			std::chrono::duration<double> wait_sec;
+			std::chrono::duration<double> total_seconds = std::chrono::duration<double>::zero();
+			std::chrono::duration<double> non_coupling_secs = std::chrono::duration<double>::zero();
+			std::chrono::duration<double> pure_compute_sec = std::chrono::duration<double>::zero();
+			std::chrono::duration<double> wait_sec = std::chrono::duration<double>::zero();
 			std::chrono::time_point<std::chrono::steady_clock> start;
 			std::chrono::time_point<std::chrono::steady_clock> start1;
+			std::chrono::duration<double> search_secs = std::chrono::duration<double>::zero();
+			std::chrono::duration<double> interp_secs = std::chrono::duration<double>::zero();
+			int searches = 0;
 
 			for(int cycle_counter = 0; cycle_counter < coupler_cycles; cycle_counter++){
 				int local_size;
 				MPI_Comm_size(coupler_comm, &local_size);
-				if(rank == root_rank){
-					printf("Coupler cycle %d starting\n", cycle_counter+1);
-					start = std::chrono::steady_clock::now();
-					MPI_Recv(left_p_variables_recv, left_nodes_size * coupler_vars, MPI_DOUBLE, left_rank, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-					start1 = std::chrono::steady_clock::now();
-					MPI_Recv(right_p_variables_recv, right_nodes_size * coupler_vars, MPI_DOUBLE, right_rank, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-					auto end = std::chrono::steady_clock::now();
-					non_coupling_secs += (end-start);
-					wait_sec = (end-start1);
-					//sort the left and right variables to be roughly the avg of the two sides
-					int counter = 0;
-					for(int i = 0; i < left_nodes_size * coupler_vars; i++){
-						if(counter < left_right_size * coupler_vars){
-							left_p_variables[counter] = left_p_variables_recv[i];
-						}else if(counter < 2 * left_nodes_size * coupler_vars){
-							right_p_variables[counter-(left_right_size * coupler_vars)] = left_p_variables_recv[i];
+
+				//share the interface out again in proportion to how quickly each rank got through its chunk since the last rebalance
+				bool repartitioned = false;
+				if(!mxn_redistribution && rebalance_freq > 0 && cycle_counter > 0 && (cycle_counter % rebalance_freq) == 0){
+					double my_cost = partition_cost.count();
+					std::vector<double> costs(total_ranks);
+					MPI_Allgather(&my_cost, 1, MPI_DOUBLE, costs.data(), 1, MPI_DOUBLE, coupler_comm);
+					partition_cost = std::chrono::duration<double>::zero();
+					repartitioned = redistribution_rebalance(left_right_size, costs, chunk_counts, chunk_displs, rebalance_tolerance, max_chunk);
+					if(repartitioned){
+						for(int c = 0; c < total_ranks; c++){
+							sg_counts[c] = chunk_counts[c] * coupler_vars;
+							sg_displs[c] = chunk_displs[c] * coupler_vars;
 						}
-						counter++;
-					}
-					for(int i = 0; i < right_nodes_size * coupler_vars; i++){
-						if(counter < left_right_size * coupler_vars){
-							left_p_variables[counter] = right_p_variables_recv[i];
-						}else if(counter < 2 * left_right_size * coupler_vars){
-							right_p_variables[counter-(left_right_size * coupler_vars)] = right_p_variables_recv[i];
+						left_right_size_chunks = chunk_counts[my_rank];
+						if(MUM == 0){
+							interp_begin = chunk_displs[my_rank];
+						}else{
+							search_size = left_right_size_chunks;
+							search_offset = chunk_displs[my_rank];
+							left_coords.resize(search_size);
+							right_coords.resize(search_size);
+							interface_buffer_resize(&left_state, search_size);
+							interface_buffer_resize(&right_state, search_size);
+							interface_buffer_resize(&left_interp, search_size);
+							interface_buffer_resize(&right_interp, search_size);
+						}
+						interp_end = interp_begin + left_right_size_chunks;
+						if(rank == root_rank && debug == true){
+							for(int c = 0; c < total_ranks; c++){
+								printf("coupler rank %d now holds %d nodes (cost %f)\n", c, chunk_counts[c], costs[c]);
+							}
 						}
-						counter++;
 					}
-					start = std::chrono::steady_clock::now();
-		        }
-
-				MPI_Barrier(coupler_comm);
-				MPI_Scatter(left_p_variables, (left_right_size_chunks * coupler_vars), MPI_DOUBLE, left_p_variables_sg, (left_right_size_chunks * coupler_vars), MPI_DOUBLE, 0, coupler_comm);
-				MPI_Barrier(coupler_comm);
-				MPI_Scatter(right_p_variables, (left_right_size_chunks * coupler_vars), MPI_DOUBLE, right_p_variables_sg, (left_right_size_chunks * coupler_vars), MPI_DOUBLE, 0, coupler_comm);
+				}
+				if(mxn_redistribution){
+					if(rank == root_rank){
+						printf("Coupler cycle %d starting\n", cycle_counter+1);
+						start = std::chrono::steady_clock::now();
+					}
+					//every coupler rank receives its chunks straight from the unit ranks that hold them
+					double trace_start = trace_now();
+					redistribution_recv(&exchange);
+					trace_record(&timeline, TRACE_WAIT, trace_start, cycle_counter);
+					if(rank == root_rank){
+						auto end = std::chrono::steady_clock::now();
+						non_coupling_secs += (end-start);
+						start = std::chrono::steady_clock::now();
+					}
+					if(MUM == 0){
+						trace_start = trace_now();
+						MPI_Allgatherv(left_p_variables_sg, sg_counts[my_rank], MPI_DOUBLE, left_p_variables, sg_counts.data(), sg_displs.data(), MPI_DOUBLE, coupler_comm);
+						MPI_Allgatherv(right_p_variables_sg, sg_counts[my_rank], MPI_DOUBLE, right_p_variables, sg_counts.data(), sg_displs.data(), MPI_DOUBLE, coupler_comm);
+						trace_record(&timeline, TRACE_UNPACK, trace_start, cycle_counter);
+					}
+				}else{
+					if(rank == root_rank){
+						printf("Coupler cycle %d starting\n", cycle_counter+1);
+						start = std::chrono::steady_clock::now();
+						//post both receives so whichever unit arrives first is reordered while the other is still in flight
+						redistribution_start_recv(&exchange);
+						for(int arrived = 0; arrived < 2; arrived++){
+							int side;
+							double trace_start = trace_now();
+							MPI_Waitany(2, exchange.recv_requests.data(), &side, MPI_STATUS_IGNORE);
+							redistribution_arrived(&exchange, side);
+							trace_record(&timeline, TRACE_WAIT, trace_start, cycle_counter);
+							trace_start = trace_now();
+							auto end = std::chrono::steady_clock::now();
+							if(arrived == 0){
+								start1 = end;
+							}else{
+								wait_sec = (end-start1);
+							}
+							non_coupling_secs += (end-start);
+							//sort the left and right variables to be roughly the avg of the two sides, the left unit's values come first
+							double *recv = (side == 0) ? left_p_variables_recv : right_p_variables_recv;
+							int recv_size = ((side == 0) ? left_nodes_size : right_nodes_size) * coupler_vars;
+							int counter = (side == 0) ? 0 : left_nodes_size * coupler_vars;
+							int counter_max = (side == 0) ? 2 * left_nodes_size * coupler_vars : 2 * left_right_size * coupler_vars;
+							for(int i = 0; i < recv_size; i++){
+								if(counter < left_right_size * coupler_vars){
+									left_p_variables[counter] = recv[i];
+								}else if(counter < counter_max){
+									right_p_variables[counter-(left_right_size * coupler_vars)] = recv[i];
+								}
+								counter++;
+							}
+							trace_record(&timeline, TRACE_UNPACK, trace_start, cycle_counter);
+							start = std::chrono::steady_clock::now();
+						}
+			        }
+
+					//the other coupler ranks wait here for the root to have both interfaces
+					double trace_start = trace_now();
+					MPI_Barrier(coupler_comm);
+					trace_record(&timeline, TRACE_WAIT, trace_start, cycle_counter);
+					trace_start = trace_now();
+					MPI_Scatterv(left_p_variables, sg_counts.data(), sg_displs.data(), MPI_DOUBLE, left_p_variables_sg, sg_counts[my_rank], MPI_DOUBLE, 0, coupler_comm);
+					MPI_Barrier(coupler_comm);
+					MPI_Scatterv(right_p_variables, sg_counts.data(), sg_displs.data(), MPI_DOUBLE, right_p_variables_sg, sg_counts[my_rank], MPI_DOUBLE, 0, coupler_comm);
 				
-				if(MUM == 0){
-					MPI_Bcast(left_p_variables, left_right_size * coupler_vars, MPI_DOUBLE, 0, coupler_comm);
-					MPI_Bcast(right_p_variables, left_right_size * coupler_vars, MPI_DOUBLE, 0, coupler_comm);
+					if(MUM == 0){
+						MPI_Bcast(left_p_variables, left_right_size * coupler_vars, MPI_DOUBLE, 0, coupler_comm);
+						MPI_Bcast(right_p_variables, left_right_size * coupler_vars, MPI_DOUBLE, 0, coupler_comm);
+					}
+					trace_record(&timeline, TRACE_UNPACK, trace_start, cycle_counter);
 				}
 
 				if(rank == root_rank){
 					start1 = std::chrono::steady_clock::now();
 				}
+				auto partition_start = std::chrono::steady_clock::now();
 				
-				//rendezvous routines start
-				if(units[unit_count].coupling_type == 'S' || cycle_counter == 0){
-					if((cycle_counter % search_freq) == 0){
-						if(MUM == 0){
-							vector_counter_max = left_right_size;//this is size of mesh recieved from broadcast
-						}else{
-							vector_counter_max = left_right_size_chunks;//this is size of mesh recieved from scatter
+				//rendezvous routines start, a new partition needs its own search
+				if(units[unit_count].coupling_type == 'S' || cycle_counter == 0 || repartitioned){
+					if((cycle_counter % search_freq) == 0 || repartitioned){
+						auto search_start = std::chrono::steady_clock::now();
+						double trace_start = trace_now();
+						//the moving side of a sliding plane advances half a node pitch every coupler cycle
+						double shift = 0.5;
+						if(units[unit_count].coupling_type == 'S'){
+							shift = 0.5 * cycle_counter;
 						}
-						if(!fastsearch){
-							for(int l = 0; l < left_search_scaling; l++){
-								vector_counter = 0;
-								sub_count = 0;
-								while(sub_count < total_ranks){
-									left_vector_of_state_vars.clear();
-									while(vector_counter < (vector_counter_max/total_ranks)){
-										node_state_vars.clear();
-										for(int i = 0; i<coupler_vars; i++){
-											if(MUM == 0){
-												node_state_vars.push_back(*(left_p_variables + (static_cast<long long>(vector_counter) * coupler_vars) + i));//essentially move along left_p_variables in chunks of NVAR
-											}else{
-												node_state_vars.push_back(*(left_p_variables_sg + (static_cast<long long>(vector_counter) * coupler_vars) + i));//essentially move along left_p_variables in chunks of NVAR
-											}
-										}
-										left_vector_of_state_vars.insert(left_vector_of_state_vars.begin(), node_state_vars);
-										vector_counter++;
-									}
-									vector_counter = 0;
-									sub_count++;
-								}
-							}
-						}else{
-							for(int l = 0; l < left_search_scaling; l++){
-								left_map_of_state_vars.clear();
-								vector_counter = 0;
-								while(vector_counter < (vector_counter_max)){
-									node_state_vars.clear();
-									for(int i = 0; i<coupler_vars; i++){
-										if(MUM == 0){
-											node_state_vars.push_back(*(left_p_variables + (static_cast<long long>(vector_counter) * coupler_vars) + i));//essentially move along left_p_variables in chunks of NVAR
-										}else{
-											node_state_vars.push_back(*(left_p_variables_sg + (static_cast<long long>(vector_counter) * coupler_vars) + i));//essentially move along left_p_variables in chunks of NVAR
-										}
-									}
-									left_map_of_state_vars.insert(std::make_pair(vector_counter, node_state_vars));
-									vector_counter++;
-								}
-							}
-				        }
-					}
-
-					if((cycle_counter % search_freq) == 0){
-						if(MUM == 0){
-							vector_counter_max = left_right_size;//this is size of mesh recieved from broadcast
-						}else{
-							vector_counter_max = left_right_size_chunks;//this is size of mesh recieved from scatter
+						interface_coordinates(left_coords.data(), search_size, search_offset, left_right_size, 0.0);
+						interface_coordinates(right_coords.data(), search_size, search_offset, left_right_size, shift);
+						if(fastsearch){
+							kdtree_build(&left_tree, left_coords.data(), search_size);
+							kdtree_build(&right_tree, right_coords.data(), search_size);
 						}
-						if(!fastsearch){
-							for(int l = 0; l < right_search_scaling; l++){
-								vector_counter = 0;
-								sub_count = 0;
-								while(sub_count < total_ranks){
-									right_vector_of_state_vars.clear();
-									while(vector_counter < (vector_counter_max/total_ranks)){
-										node_state_vars.clear();
-										for(int i = 0; i<coupler_vars; i++){
-											if(MUM == 0){
-												node_state_vars.push_back(*(right_p_variables + (static_cast<long long>(vector_counter) * coupler_vars) + i));//essentially move along right_p_variables in chunks of NVAR
-											}else{
-												node_state_vars.push_back(*(right_p_variables_sg + (static_cast<long long>(vector_counter) * coupler_vars) + i));//essentially move along right_p_variables in chunks of NVAR
-											}
-										}
-										right_vector_of_state_vars.insert(right_vector_of_state_vars.begin(), node_state_vars);
-										vector_counter++;
-									}
-									vector_counter = 0;
-									sub_count++;
+						for(int l = 0; l < left_search_scaling; l++){
+							csr_begin(&right_to_left, search_size, interp_donors);
+							for(int i = 0; i < search_size; i++){
+								int found;
+								if(fastsearch){
+									found = kdtree_k_nearest(&right_tree, left_coords[i], interp_donors, donor_ids.data(), donor_dist2.data());
+								}else{
+									found = linear_k_nearest(right_coords.data(), search_size, left_coords[i], interp_donors, donor_ids.data(), donor_dist2.data());
 								}
+								csr_add_row_idw(&right_to_left, donor_ids.data(), donor_dist2.data(), found);
 							}
-						}else{
-							for(int l = 0; l < right_search_scaling; l++){
-								right_map_of_state_vars.clear();
-								vector_counter = 0;
-								while(vector_counter < (vector_counter_max)){
-									node_state_vars.clear();
-									for(int i = 0; i<coupler_vars; i++){
-										if(MUM == 0){
-											node_state_vars.push_back(*(right_p_variables + (static_cast<long long>(vector_counter) * coupler_vars) + i));//essentially move along right_p_variables in chunks of NVAR
-										}else{
-											node_state_vars.push_back(*(right_p_variables_sg + (static_cast<long long>(vector_counter) * coupler_vars) + i));//essentially move along right_p_variables in chunks of NVAR
-										}
-									}
-									right_map_of_state_vars.insert(std::make_pair(vector_counter, node_state_vars));
-									vector_counter++;
+						}
+						for(int l = 0; l < right_search_scaling; l++){
+							csr_begin(&left_to_right, search_size, interp_donors);
+							for(int i = 0; i < search_size; i++){
+								int found;
+								if(fastsearch){
+									found = kdtree_k_nearest(&left_tree, right_coords[i], interp_donors, donor_ids.data(), donor_dist2.data());
+								}else{
+									found = linear_k_nearest(left_coords.data(), search_size, right_coords[i], interp_donors, donor_ids.data(), donor_dist2.data());
 								}
+								csr_add_row_idw(&left_to_right, donor_ids.data(), donor_dist2.data(), found);
 							}
-				        }
-					}
-					//this routine is used to convert the tree in the based search to a vector so the interpolation routine can run as before
-					if(fastsearch){
-						vector_counter_max = left_right_size_chunks;
-						left_vector_of_state_vars.clear();
-						right_vector_of_state_vars.clear();
-						for(int i=0; i<(vector_counter_max/total_ranks); i++){
-							left_vector_of_state_vars.insert(left_vector_of_state_vars.end(), left_map_of_state_vars.at(i));
-							right_vector_of_state_vars.insert(right_vector_of_state_vars.end(), right_map_of_state_vars.at(i));
 						}
-						if(units[unit_count].coupling_type == 'S'){
+						if(fastsearch && units[unit_count].coupling_type == 'S'){
 							left_search_scaling = adjusted_sizes_left;
 							right_search_scaling = adjusted_sizes_right;
 						}
+						search_secs += std::chrono::steady_clock::now() - search_start;
+						trace_record(&timeline, TRACE_SEARCH, trace_start, cycle_counter);
+						searches++;
 					}
 				}
 				//rendezvous routines end
 	
 				//interpolate routine start
+				auto interp_start = std::chrono::steady_clock::now();
+				double trace_start = trace_now();
 				if(units[unit_count].coupling_type == 'S' || units[unit_count].coupling_type == 'O'){
-					node_state_vars_left.clear();
-					node_state_vars_right.clear();
-					node_state_vars_temp.clear();
-					vector_counter = 0;
-					sub_count = 0;
-					vector_counter_max = left_right_size_chunks;//this is size of mesh recieved from scatter
-					while(sub_count < (total_ranks*(interp_scaling/((adjusted_sizes_left + adjusted_sizes_right)/2)))){//TODO: changes the adjusted_sizes to whichever is lower
-						while(vector_counter < vector_counter_max/total_ranks){
-							node_state_vars_left = left_vector_of_state_vars.at(vector_counter);
-							node_state_vars_right = right_vector_of_state_vars.at(vector_counter);
-							node_state_vars_temp = node_state_vars_right;
-							for(int i = 0; i<coupler_vars; i++){
-								node_state_vars_right.at(i) = (node_state_vars_left.at(i) + node_state_vars_right.at(i))/2;
-								node_state_vars_left.at(i) = (node_state_vars_left.at(i) + node_state_vars_temp.at(i))/2;
-							}
-							vector_counter++;
-						}
-						vector_counter = 0;
-						sub_count++;
-					}
+					interface_buffer_load(&left_state, (MUM == 0) ? left_p_variables : left_p_variables_sg);
+					interface_buffer_load(&right_state, (MUM == 0) ? right_p_variables : right_p_variables_sg);
+					//one SpMV per direction brings the other side's state onto each node, which is then averaged with the node's own
+					csr_apply(&right_to_left, &right_state, &left_interp, interp_begin, interp_end);
+					csr_apply(&left_to_right, &left_state, &right_interp, interp_begin, interp_end);
+					interface_average(&left_state, &left_interp, interp_begin, interp_end);
+					interface_average(&right_state, &right_interp, interp_begin, interp_end);
+					interface_buffer_store(&left_interp, left_p_variables_sg, interp_begin, interp_end);
+					interface_buffer_store(&right_interp, right_p_variables_sg, interp_begin, interp_end);
 				}else if(units[unit_count].coupling_type == 'C'){
-					std::vector<double> quad_array_rt;
-					std::vector<double> quad_array_lt;
 					for(int l = 0; l < 1; l++){
-						quad_array_rt.clear();
-						quad_array_lt.clear();
-						for(int i = 0; i < ar_size_max*0.7; i++){
-							quad_array_rt.push_back(0.0);
-							quad_array_lt.push_back(0.0);
+						#pragma omp parallel for simd schedule(static)
+						for(int i = 0; i < quad_size; i++){
+							quad_array_rt[i] = 0.0;
+							quad_array_lt[i] = 0.0;
 							for(int k = 0; k < 4; k++){
-								quad_array_rt.at(i) = (quad_array_rt.at(i) + data_ran[i][k]);
-								quad_array_lt.at(i) = (quad_array_lt.at(i) + data_ran[i][k]);
+								quad_array_rt[i] = (quad_array_rt[i] + data_ran[i][k]);
+								quad_array_lt[i] = (quad_array_lt[i] + data_ran[i][k]);
 							}
-							quad_array_rt.at(i) = (quad_array_rt.at(i)/4);
-							quad_array_lt.at(i) = (quad_array_lt.at(i)/4);
+							quad_array_rt[i] = (quad_array_rt[i]/4);
+							quad_array_lt[i] = (quad_array_lt[i]/4);
 						}
 					}
-					vector_counter_max = left_right_size_chunks;//this is size of mesh recieved from scatter
+					//nodes b and b + quad_stride update the same quad entry, so each thread takes whole residue classes to keep the serial result
+					int quad_stride = std::max(ar_size_max/20,1);
+					int quad_nodes = left_right_size_chunks/5;
 					for(int l = 0; l < 7; l++){
-						for(int b = 0; b < vector_counter_max/5; b++){
-							int temp = 0;
-							for(int i = 0; i < 3; i++){
-								if(data_ran[b][i] != data_ran[b][i % 3 + 1]){
-									temp = temp + 1;
-									quad_array_rt.at(b % (std::max(ar_size_max/20,1))) = data_ran[b][temp];
+						#pragma omp parallel for schedule(static)
+						for(int q = 0; q < std::min(quad_stride, quad_nodes); q++){
+							for(int b = q; b < quad_nodes; b += quad_stride){
+								int temp = 0;
+								for(int i = 0; i < 3; i++){
+									if(data_ran[b][i] != data_ran[b][i % 3 + 1]){
+										temp = temp + 1;
+										quad_array_rt[q] = data_ran[b][temp];
+									}
 								}
 							}
 						}
 					}
 				}
+				interp_secs += std::chrono::steady_clock::now() - interp_start;
+				trace_record(&timeline, TRACE_INTERPOLATE, trace_start, cycle_counter);
+				partition_cost += std::chrono::steady_clock::now() - partition_start;
 				if(rank == root_rank){
 					auto end1 = std::chrono::steady_clock::now();
 					pure_compute_sec = (end1-start1);
 				}
 				
 				//interpolate routine end
-				MPI_Barrier(coupler_comm);
-		        MPI_Gather(left_p_variables_sg, (left_right_size_chunks * coupler_vars), MPI_DOUBLE, left_p_variables, (left_right_size_chunks * coupler_vars), MPI_DOUBLE, 0, coupler_comm);
-				MPI_Barrier(coupler_comm);
-		        MPI_Gather(right_p_variables_sg, (left_right_size_chunks * coupler_vars), MPI_DOUBLE, right_p_variables, (left_right_size_chunks * coupler_vars), MPI_DOUBLE, 0, coupler_comm);
+				if(mxn_redistribution){
+					trace_start = trace_now();
+					redistribution_send(&exchange);
+					trace_record(&timeline, TRACE_SEND, trace_start, cycle_counter);
+					if(rank == root_rank){
+						auto end = std::chrono::steady_clock::now();
+						total_seconds += (end-start);
+						printf("Coupler cycle %d ending\n", cycle_counter+1);
+					}
+				}else{
+					trace_start = trace_now();
+					MPI_Barrier(coupler_comm);
+			        MPI_Gatherv(left_p_variables_sg, sg_counts[my_rank], MPI_DOUBLE, left_p_variables, sg_counts.data(), sg_displs.data(), MPI_DOUBLE, 0, coupler_comm);
+					MPI_Barrier(coupler_comm);
+			        MPI_Gatherv(right_p_variables_sg, sg_counts[my_rank], MPI_DOUBLE, right_p_variables, sg_counts.data(), sg_displs.data(), MPI_DOUBLE, 0, coupler_comm);
+					trace_record(&timeline, TRACE_PACK, trace_start, cycle_counter);
 				
-				if(rank == root_rank){
-		            MPI_Send(right_p_variables_recv, right_nodes_size * coupler_vars, MPI_DOUBLE, right_rank, 0, MPI_COMM_WORLD);
-		            MPI_Send(left_p_variables_recv, left_nodes_size * coupler_vars, MPI_DOUBLE, left_rank, 0, MPI_COMM_WORLD);
-					auto end = std::chrono::steady_clock::now();
-					total_seconds += (end-start);
-					printf("Coupler cycle %d ending\n", cycle_counter+1);
-		        }
+					if(rank == root_rank){
+						//the receive buffers are reused next cycle so both sends must have completed
+						trace_start = trace_now();
+						redistribution_send(&exchange);
+						trace_record(&timeline, TRACE_SEND, trace_start, cycle_counter);
+						auto end = std::chrono::steady_clock::now();
+						total_seconds += (end-start);
+						printf("Coupler cycle %d ending\n", cycle_counter+1);
+			        }
+				}
 			}
 			MPI_Barrier(coupler_comm);
 			if(rank == root_rank){
 				printf("total coupling time is %f\n", total_seconds.count());
 				printf("total time waiting %f\n", non_coupling_secs.count());
-				printf("time between left send and right send %f\n",wait_sec.count());
+				// the MxN exchange has no single arrival order to measure
+				if(!mxn_redistribution){
+					printf("time between first and second unit arriving %f\n",wait_sec.count());
+				}
 				printf("total pure compute time is %f\n", pure_compute_sec.count());
+				if(record_calibration){
+					char type = units[unit_count].coupling_type;
+					perf_model_record("search", type, unit_count, total_ranks, left_right_size, search_secs.count() / std::max(searches, 1));
+					perf_model_record("interp", type, unit_count, total_ranks, left_right_size, interp_secs.count() / coupler_cycles);
+					perf_model_record("comm", type, unit_count, total_ranks, left_right_size, std::max(0.0, (total_seconds - search_secs - interp_secs).count()) / coupler_cycles);
+				}
+			}
+			if(codec != CODEC_RAW){
+				double codec_stats[3] = {0.0, 0.0, 0.0};
+				if(mxn_redistribution || funnel_root){
+					codec_stats[0] = exchange.raw_bytes;
+					codec_stats[1] = exchange.packed_bytes;
+					codec_stats[2] = exchange.codec_seconds;
+				}
+				double codec_totals[3];
+				MPI_Reduce(codec_stats, codec_totals, 3, MPI_DOUBLE, MPI_SUM, 0, coupler_comm);
+				//against sending the doubles as they are
+				double codec_error = (mxn_redistribution || funnel_root) ? exchange.codec_max_error : 0.0;
+				double codec_max_error;
+				MPI_Reduce(&codec_error, &codec_max_error, 1, MPI_DOUBLE, MPI_MAX, 0, coupler_comm);
+				if(rank == root_rank){
+					printf("interface compression ratio %f (%.0f bytes sent and received as %.0f)\n", (codec_totals[1] > 0.0) ? codec_totals[0] / codec_totals[1] : 1.0, codec_totals[0], codec_totals[1]);
+					printf("total codec time %f\n", codec_totals[2]);
+					printf("largest error packing added to an interface value %e\n", codec_max_error);
+				}
+			}
+			long memory_kb[2] = {peak_memory_kb(), (long) (work.capacity / 1024)};
+			std::vector<long> all_memory_kb(2 * total_ranks);
+			MPI_Gather(memory_kb, 2, MPI_LONG, all_memory_kb.data(), 2, MPI_LONG, 0, coupler_comm);
+			if(rank == root_rank){
+				for(int c = 0; c < total_ranks; c++){
+					printf("coupler rank %d peak memory %ld kB (work arrays %ld kB)\n", c, all_memory_kb[2*c], all_memory_kb[2*c+1]);
+				}
 			}
+			trace_write(&timeline, coupler_comm);
+			redistribution_free(&exchange);
+			arena_free(&work);
 			MPI_Finalize();
 	   		exit(0);
 		}
@@ -0,0 +1,161 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "structures.h"
+
+#ifndef INPUT_DECKS_H
+#define INPUT_DECKS_H
+
+/*
+ * Input decks of the work units. Rank 0 reads every deck once at startup and
+ * each unit is sent only the deck for its type, so no other rank touches the
+ * filesystem for input. A deck whose file is missing is left empty and it is
+ * up to the unit that needs it to complain.
+ */
+struct input_decks{
+  std::vector<std::string> mg_files;//mg_files.input, one MG-CFD input file per line for instance number line + 1
+  std::vector<std::string> simpic_parameters;//simpic_parameters, the arguments on its first line
+  std::vector<std::string> fenics_input;//Fenics_input, the arguments on every line, a blank line is one empty argument
+};
+
+//appends every line of the file without its newline, returns false if it cannot be opened
+inline bool input_decks_read_lines(const char *file_name, std::vector<std::string> &lines){
+  FILE *file = fopen(file_name, "r");
+  if(file == NULL){
+    return false;
+  }
+  char *line_buf = NULL;
+  size_t line_buf_size = 0;
+  ssize_t line_size;
+  while((line_size = getline(&line_buf, &line_buf_size, file)) >= 0){
+    std::string line(line_buf, line_size);
+    line.erase(line.find_last_not_of("\r\n") + 1);
+    lines.push_back(line);
+  }
+  free(line_buf);
+  fclose(file);
+  return true;
+}
+
+inline void input_decks_split(const std::string &line, std::vector<std::string> &words){
+  size_t begin = line.find_first_not_of(" \t");
+  while(begin != std::string::npos){
+    size_t end = line.find_first_of(" \t", begin);
+    words.push_back(line.substr(begin, end - begin));
+    begin = line.find_first_not_of(" \t", end);
+  }
+}
+
+//reads all of the unit decks, called on rank 0 only
+inline void input_decks_load(struct input_decks *d){
+  std::vector<std::string> lines;
+  input_decks_read_lines("mg_files.input", d->mg_files);
+  if(input_decks_read_lines("simpic_parameters", lines) && !lines.empty()){
+    input_decks_split(lines[0], d->simpic_parameters);
+  }
+  lines.clear();
+  input_decks_read_lines("Fenics_input", lines);
+  for(int i = 0; i < (int) lines.size(); i++){
+    size_t before = d->fenics_input.size();
+    input_decks_split(lines[i], d->fenics_input);
+    if(d->fenics_input.size() == before){
+      d->fenics_input.push_back(lines[i]);
+    }
+  }
+}
+
+//the deck a unit of the given type reads, or NULL if it has none
+inline std::vector<std::string> *input_decks_for(struct input_decks *d, char type){
+  if(type == 'M'){
+    return &d->mg_files;
+  }else if(type == 'P'){
+    return &d->simpic_parameters;
+  }else if(type == 'F'){
+    return &d->fenics_input;
+  }
+  return NULL;
+}
+
+//serialises the deck for the given unit type as consecutive nul terminated strings
+inline void input_decks_pack(struct input_decks *d, char type, std::vector<char> &buf){
+  buf.clear();
+  std::vector<std::string> *deck = input_decks_for(d, type);
+  for(int i = 0; deck != NULL && i < (int) deck->size(); i++){
+    buf.insert(buf.end(), (*deck)[i].begin(), (*deck)[i].end());
+    buf.push_back('\0');
+  }
+}
+
+inline void input_decks_unpack(struct input_decks *d, char type, const std::vector<char> &buf){
+  std::vector<std::string> *deck = input_decks_for(d, type);
+  if(deck == NULL){
+    return;
+  }
+  deck->clear();
+  for(size_t begin = 0; begin < buf.size(); begin += deck->back().size() + 1){
+    deck->push_back(std::string(&buf[begin]));
+  }
+}
+
+/*
+ * Hands every work unit its deck. Rank 0 holds the decks read by
+ * input_decks_load and sends each unit root (world rank unit_roots[i]) the one
+ * for its unit, which the root then broadcasts over unit_comm. Called by every
+ * rank, coupler units just get an empty deck.
+ */
+inline void input_decks_distribute(struct input_decks *d, const struct unit *units, int num_of_units, int my_unit, const int *unit_roots, MPI_Comm unit_comm){
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  std::vector<char> buf;
+  if(rank == 0){
+    for(int i = 0; i < num_of_units; i++){
+      if(units[i].type != 'C' && unit_roots[i] != 0){
+        input_decks_pack(d, units[i].type, buf);
+        MPI_Send(buf.data(), buf.size(), MPI_CHAR, unit_roots[i], 0, MPI_COMM_WORLD);
+      }
+    }
+    input_decks_pack(d, units[my_unit].type, buf);
+  }else if(rank == unit_roots[my_unit] && units[my_unit].type != 'C'){
+    MPI_Status status;
+    int buf_size;
+    MPI_Probe(0, 0, MPI_COMM_WORLD, &status);
+    MPI_Get_count(&status, MPI_CHAR, &buf_size);
+    buf.resize(buf_size);
+    MPI_Recv(buf.data(), buf_size, MPI_CHAR, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+  int buf_size = buf.size();
+  MPI_Bcast(&buf_size, 1, MPI_INT, 0, unit_comm);
+  buf.resize(buf_size);
+  MPI_Bcast(buf.data(), buf_size, MPI_CHAR, 0, unit_comm);
+  input_decks_unpack(d, units[my_unit].type, buf);
+}
+
+//gives every rank the units rank 0 parsed from cpx_input.cfg, minus the rank lists which are worked out locally
+inline void input_decks_bcast_units(std::vector<struct unit> &units){
+  int num_of_units = units.size();
+  MPI_Bcast(&num_of_units, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  std::vector<int> buf(5 * num_of_units);
+  for(int i = 0; i < (int) units.size(); i++){
+    buf[5*i] = units[i].type;
+    buf[5*i+1] = units[i].processes;
+    buf[5*i+2] = units[i].coupling_type;
+    buf[5*i+3] = (units[i].type == 'C') ? units[i].mgcfd_units[0] : 0;
+    buf[5*i+4] = (units[i].type == 'C') ? units[i].mgcfd_units[1] : 0;
+  }
+  MPI_Bcast(buf.data(), buf.size(), MPI_INT, 0, MPI_COMM_WORLD);
+  units.resize(num_of_units);
+  for(int i = 0; i < num_of_units; i++){
+    units[i].type = buf[5*i];
+    units[i].processes = buf[5*i+1];
+    units[i].coupling_type = buf[5*i+2];
+    units[i].mgcfd_units.clear();
+    if(units[i].type == 'C'){
+      units[i].mgcfd_units.push_back(buf[5*i+3]);
+      units[i].mgcfd_units.push_back(buf[5*i+4]);
+    }
+  }
+}
+#endif
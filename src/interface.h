@@ -0,0 +1,84 @@
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "structures.h"
+#include "const.h"
+
+#ifndef INTERFACE_H
+#define INTERFACE_H
+
+/*
+ * The units only send interface state to the coupler, not geometry, so the
+ * coupler lays the interface nodes out on an annulus (r in [1, 2]) to give
+ * the rendezvous search something real to work on. Nodes are numbered radius
+ * first, so a contiguous block of nodes covers an angular sector and the
+ * chunk held by each coupler rank is spatially compact. 'shift' rotates the
+ * whole side by that many node pitches, which is how the moving side of a
+ * sliding plane (and the misaligned side of other couplings) is modelled.
+ */
+inline void interface_coordinates(double3 *coords, long long n, long long offset, long long total, double shift){
+  long long n_radial = std::max(1LL, (long long) ceil(sqrt(total / 16.0)));
+  long long n_theta = std::max(1LL, (total + n_radial - 1) / n_radial);
+  for(long long i = 0; i < n; i++){
+    long long node = offset + i;
+    double r = 1.0 + (double) (node % n_radial) / n_radial;
+    double theta = (2 * PI * ((node / n_radial) + shift)) / n_theta;
+    coords[i].x = r * cos(theta);
+    coords[i].y = r * sin(theta);
+    coords[i].z = 0.0;
+  }
+}
+
+/*
+ * Structure-of-arrays interface state: variable v of node i lives at
+ * data[v * size + i], so loops over one variable stream through memory.
+ * The storage is sized once when the coupler starts, for the most nodes a
+ * rebalance may give a rank, and reused every cycle.
+ */
+struct interface_buffer{
+  int size;//number of interface nodes
+  int vars;//state variables per node
+  std::vector<double> data;
+};
+
+//storage for up to capacity nodes, of which the buffer holds size
+inline void interface_buffer_alloc(struct interface_buffer *buf, int size, int vars, int capacity){
+  buf->size = size;
+  buf->vars = vars;
+  buf->data.assign((long long) capacity * vars, 0.0);
+}
+
+//changes how many nodes the buffer holds, within the capacity it was allocated with, and zeroes them
+inline void interface_buffer_resize(struct interface_buffer *buf, int size){
+  buf->size = size;
+  std::fill(buf->data.begin(), buf->data.begin() + (long long) size * buf->vars, 0.0);
+}
+
+inline double *interface_buffer_var(struct interface_buffer *buf, int v){
+  return buf->data.data() + (long long) v * buf->size;
+}
+
+//transposes node-major state as it arrives over MPI into the buffer
+inline void interface_buffer_load(struct interface_buffer *buf, const double *state){
+  #pragma omp parallel
+  for(int v = 0; v < buf->vars; v++){
+    double *var = interface_buffer_var(buf, v);
+    #pragma omp for simd schedule(static)
+    for(int i = 0; i < buf->size; i++){
+      var[i] = state[(long long) i * buf->vars + v];
+    }
+  }
+}
+
+//writes nodes [begin, end) of the buffer back out in node-major order
+inline void interface_buffer_store(struct interface_buffer *buf, double *state, int begin, int end){
+  #pragma omp parallel
+  for(int v = 0; v < buf->vars; v++){
+    const double *var = interface_buffer_var(buf, v);
+    #pragma omp for simd schedule(static)
+    for(int i = begin; i < end; i++){
+      state[(long long) (i - begin) * buf->vars + v] = var[i];
+    }
+  }
+}
+#endif
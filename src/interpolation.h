@@ -0,0 +1,87 @@
+#include <vector>
+#include "interface.h"
+
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+
+/*
+ * Sparse interpolation operator in CSR form. Row i holds the donor nodes
+ * and weights that produce the value at target node i, so once the search
+ * has built it, interpolating a whole interface is a single SpMV.
+ */
+struct csr_operator{
+  int rows;
+  std::vector<int> row_ptr;
+  std::vector<int> col_idx;
+  std::vector<double> weights;
+};
+
+//empties the operator ready for rows to be appended, keeping its storage
+inline void csr_begin(struct csr_operator *op, int rows, int max_row_entries){
+  op->rows = 0;
+  op->row_ptr.assign(1, 0);
+  op->col_idx.clear();
+  op->weights.clear();
+  op->row_ptr.reserve(rows + 1);
+  op->col_idx.reserve((long long) rows * max_row_entries);
+  op->weights.reserve((long long) rows * max_row_entries);
+}
+
+/*
+ * Appends a row built from n donors sorted nearest first, weighted by inverse
+ * squared distance. A donor that coincides with the target gets all of the
+ * weight.
+ */
+inline void csr_add_row_idw(struct csr_operator *op, const int *ids, const double *dist2, int n){
+  if(n > 0 && dist2[0] == 0.0){
+    n = 1;
+  }
+  double total = 0.0;
+  for(int j = 0; j < n; j++){
+    total += (dist2[j] == 0.0) ? 1.0 : 1.0 / dist2[j];
+  }
+  for(int j = 0; j < n; j++){
+    op->col_idx.push_back(ids[j]);
+    op->weights.push_back(((dist2[j] == 0.0) ? 1.0 : 1.0 / dist2[j]) / total);
+  }
+  op->row_ptr.push_back(op->col_idx.size());
+  op->rows++;
+}
+
+/*
+ * out = op * x for rows [begin, end); x and out are indexed by donor and
+ * target node respectively. Rows are shared between threads and each thread
+ * vectorises across its rows, one variable at a time, gathering the donors.
+ */
+inline void csr_apply(const struct csr_operator *op, struct interface_buffer *x, struct interface_buffer *out, int begin, int end){
+  const int *row_ptr = op->row_ptr.data();
+  const int *col_idx = op->col_idx.data();
+  const double *weights = op->weights.data();
+  #pragma omp parallel
+  for(int v = 0; v < out->vars; v++){
+    const double *x_var = interface_buffer_var(x, v);
+    double *out_var = interface_buffer_var(out, v);
+    #pragma omp for simd schedule(static)
+    for(int i = begin; i < end; i++){
+      double sum = 0.0;
+      for(int j = row_ptr[i]; j < row_ptr[i + 1]; j++){
+        sum += weights[j] * x_var[col_idx[j]];
+      }
+      out_var[i] = sum;
+    }
+  }
+}
+
+//out = (own + out) / 2 for nodes [begin, end), blending the interpolated state with the node's own
+inline void interface_average(struct interface_buffer *own, struct interface_buffer *out, int begin, int end){
+  #pragma omp parallel
+  for(int v = 0; v < out->vars; v++){
+    const double *own_var = interface_buffer_var(own, v);
+    double *out_var = interface_buffer_var(out, v);
+    #pragma omp for simd schedule(static)
+    for(int i = begin; i < end; i++){
+      out_var[i] = (own_var[i] + out_var[i])/2;
+    }
+  }
+}
+#endif
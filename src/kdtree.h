@@ -0,0 +1,188 @@
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "structures.h"
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+/*
+ * Balanced k-d tree over interface node coordinates, used by the coupler
+ * rendezvous to find donor nodes. The tree is implicit: the node covering
+ * [lo, hi) is stored at position (lo + hi) / 2, so only the split axis of
+ * each node needs to be kept alongside the reordered points.
+ */
+struct kdtree{
+  int size;
+  std::vector<double3> points;//points in tree order
+  std::vector<int> ids;//original index of each point in tree order
+  std::vector<char> axis;//split axis (0, 1 or 2) of the node at each position
+};
+
+inline double kdtree_coord(const double3 &p, int a){
+  return (a == 0) ? p.x : ((a == 1) ? p.y : p.z);
+}
+
+inline double kdtree_dist2(const double3 &a, const double3 &b){
+  double dx = a.x - b.x;
+  double dy = a.y - b.y;
+  double dz = a.z - b.z;
+  return dx*dx + dy*dy + dz*dz;
+}
+
+inline void kdtree_build_range(struct kdtree *tree, const double3 *coords, int lo, int hi){
+  if(hi - lo <= 0){
+    return;
+  }
+  //split along the axis with the largest spread so flat interfaces stay balanced
+  double3 min = coords[tree->ids[lo]];
+  double3 max = min;
+  for(int i = lo + 1; i < hi; i++){
+    const double3 &p = coords[tree->ids[i]];
+    min.x = std::min(min.x, p.x); max.x = std::max(max.x, p.x);
+    min.y = std::min(min.y, p.y); max.y = std::max(max.y, p.y);
+    min.z = std::min(min.z, p.z); max.z = std::max(max.z, p.z);
+  }
+  int a = 0;
+  double spread = max.x - min.x;
+  if(max.y - min.y > spread){
+    a = 1;
+    spread = max.y - min.y;
+  }
+  if(max.z - min.z > spread){
+    a = 2;
+  }
+  int mid = (lo + hi) / 2;
+  std::nth_element(tree->ids.begin() + lo, tree->ids.begin() + mid, tree->ids.begin() + hi,
+                   [coords, a](int l, int r){ return kdtree_coord(coords[l], a) < kdtree_coord(coords[r], a); });
+  tree->axis[mid] = a;
+  kdtree_build_range(tree, coords, lo, mid);
+  kdtree_build_range(tree, coords, mid + 1, hi);
+}
+
+//sizes the tree's storage for up to n coordinates, so later builds do not allocate
+inline void kdtree_reserve(struct kdtree *tree, int n){
+  tree->points.reserve(n);
+  tree->ids.reserve(n);
+  tree->axis.reserve(n);
+}
+
+//(re)builds the tree over n coordinates, reusing the tree's storage
+inline void kdtree_build(struct kdtree *tree, const double3 *coords, int n){
+  tree->size = n;
+  tree->ids.resize(n);
+  tree->axis.resize(n);
+  tree->points.resize(n);
+  for(int i = 0; i < n; i++){
+    tree->ids[i] = i;
+  }
+  kdtree_build_range(tree, coords, 0, n);
+  for(int i = 0; i < n; i++){
+    tree->points[i] = coords[tree->ids[i]];
+  }
+}
+
+inline void kdtree_nearest_range(const struct kdtree *tree, const double3 &query, int lo, int hi, int *best, double *best_dist2){
+  if(hi - lo <= 0){
+    return;
+  }
+  int mid = (lo + hi) / 2;
+  double d2 = kdtree_dist2(query, tree->points[mid]);
+  if(d2 < *best_dist2){
+    *best_dist2 = d2;
+    *best = mid;
+  }
+  int a = tree->axis[mid];
+  double diff = kdtree_coord(query, a) - kdtree_coord(tree->points[mid], a);
+  if(diff < 0){
+    kdtree_nearest_range(tree, query, lo, mid, best, best_dist2);
+    if(diff*diff < *best_dist2){
+      kdtree_nearest_range(tree, query, mid + 1, hi, best, best_dist2);
+    }
+  }else{
+    kdtree_nearest_range(tree, query, mid + 1, hi, best, best_dist2);
+    if(diff*diff < *best_dist2){
+      kdtree_nearest_range(tree, query, lo, mid, best, best_dist2);
+    }
+  }
+}
+
+//returns the original index of the point closest to query, or -1 if the tree is empty
+inline int kdtree_nearest(const struct kdtree *tree, const double3 &query){
+  int best = -1;
+  double best_dist2 = 1e300;
+  kdtree_nearest_range(tree, query, 0, tree->size, &best, &best_dist2);
+  return (best < 0) ? -1 : tree->ids[best];
+}
+
+//heap holds (distance squared, tree position) pairs with the furthest candidate at the front
+inline void kdtree_k_nearest_range(const struct kdtree *tree, const double3 &query, int lo, int hi, int k, std::vector< std::pair<double, int> > &heap){
+  if(hi - lo <= 0){
+    return;
+  }
+  int mid = (lo + hi) / 2;
+  double d2 = kdtree_dist2(query, tree->points[mid]);
+  if((int) heap.size() < k){
+    heap.push_back(std::make_pair(d2, mid));
+    std::push_heap(heap.begin(), heap.end());
+  }else if(d2 < heap.front().first){
+    std::pop_heap(heap.begin(), heap.end());
+    heap.back() = std::make_pair(d2, mid);
+    std::push_heap(heap.begin(), heap.end());
+  }
+  int a = tree->axis[mid];
+  double diff = kdtree_coord(query, a) - kdtree_coord(tree->points[mid], a);
+  int near_lo = (diff < 0) ? lo : mid + 1;
+  int near_hi = (diff < 0) ? mid : hi;
+  int far_lo = (diff < 0) ? mid + 1 : lo;
+  int far_hi = (diff < 0) ? hi : mid;
+  kdtree_k_nearest_range(tree, query, near_lo, near_hi, k, heap);
+  if((int) heap.size() < k || diff*diff < heap.front().first){
+    kdtree_k_nearest_range(tree, query, far_lo, far_hi, k, heap);
+  }
+}
+
+/*
+ * Finds the k points closest to query, nearest first. Returns how many were
+ * found (fewer than k only if the tree is smaller than k); ids receives their
+ * original indices and dist2 their squared distances (dist2 may be NULL).
+ */
+inline int kdtree_k_nearest(const struct kdtree *tree, const double3 &query, int k, int *ids, double *dist2){
+  std::vector< std::pair<double, int> > heap;
+  heap.reserve(k);
+  kdtree_k_nearest_range(tree, query, 0, tree->size, k, heap);
+  std::sort_heap(heap.begin(), heap.end());
+  for(int i = 0; i < (int) heap.size(); i++){
+    ids[i] = tree->ids[heap[i].second];
+    if(dist2 != NULL){
+      dist2[i] = heap[i].first;
+    }
+  }
+  return heap.size();
+}
+
+//brute force equivalent of kdtree_k_nearest, used when the tree based search is disabled
+inline int linear_k_nearest(const double3 *coords, int n, const double3 &query, int k, int *ids, double *dist2){
+  std::vector< std::pair<double, int> > heap;
+  heap.reserve(k);
+  for(int i = 0; i < n; i++){
+    double d2 = kdtree_dist2(query, coords[i]);
+    if((int) heap.size() < k){
+      heap.push_back(std::make_pair(d2, i));
+      std::push_heap(heap.begin(), heap.end());
+    }else if(d2 < heap.front().first){
+      std::pop_heap(heap.begin(), heap.end());
+      heap.back() = std::make_pair(d2, i);
+      std::push_heap(heap.begin(), heap.end());
+    }
+  }
+  std::sort_heap(heap.begin(), heap.end());
+  for(int i = 0; i < (int) heap.size(); i++){
+    ids[i] = heap[i].second;
+    if(dist2 != NULL){
+      dist2[i] = heap[i].first;
+    }
+  }
+  return heap.size();
+}
+#endif
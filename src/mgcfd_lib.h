@@ -1,6 +1,7 @@
 #include <mpi.h>
 #include <vector>
 #include "structures.h"
+#include "input_decks.h"
 
-int main_mgcfd(int, char**, MPI_Fint, int, struct unit [], struct locators []);
+int main_mgcfd(int, char**, MPI_Fint, int, struct unit [], struct input_decks *);
 
@@ -0,0 +1,396 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "structures.h"
+
+#ifndef PERF_MODEL_H
+#define PERF_MODEL_H
+
+/*
+ * Performance model of a coupled run, fitted to calibration runs. With
+ * record_calibration on, every unit root and coupler root appends one line
+ * per measured component to PERF_MODEL_FILE:
+ *
+ *   <component> <type> <unit> <processes> <nodes> <seconds>
+ *
+ * unit is the unit's position in cpx_input.cfg and nodes its problem size,
+ * the mesh of a work unit or the interface of a coupler. The components are a work unit's solver time per coupling cycle
+ * ("unit"), a coupler's time per search ("search"), per interpolation
+ * ("interp") and the rest of its coupling cycle once both interfaces are in
+ * ("comm"). Solver, search and interpolation times are fitted per component
+ * and unit type to t = serial + parallel * nodes / processes, the coupler's
+ * data movement to t = latency + per_node * nodes. A coupled cycle waits for
+ * the slower of a coupler's two units and then the coupler, unless replies
+ * may be stale, in which case the coupler overlaps the units.
+ */
+#define PERF_MODEL_FILE "cpx_calibration.dat"
+
+struct perf_sample{
+  char component[8];
+  char type;
+  int unit;
+  int processes;
+  double nodes;
+  double seconds;
+};
+
+struct perf_fit{
+  double serial;
+  double parallel;
+  int samples;
+};
+
+struct perf_prediction{
+  std::vector<double> seconds;//per unit, solver or coupler time per coupling cycle
+  double cycle;//seconds per coupling cycle
+  double total;//seconds for the whole run
+  int missing;//first unit without calibration data, -1 if there is none
+};
+
+inline void perf_model_record(const char *component, char type, int unit, int processes, double nodes, double seconds){
+  FILE *fp = fopen(PERF_MODEL_FILE, "a");
+  if(fp == NULL){
+    fprintf(stderr, "Warning: could not append to %s, calibration sample lost\n", PERF_MODEL_FILE);
+    return;
+  }
+  fprintf(fp, "%s %c %d %d %.0f %.9e\n", component, type, unit, processes, nodes, seconds);
+  fclose(fp);
+}
+
+inline void perf_model_load(std::vector<struct perf_sample> &samples){
+  FILE *fp = fopen(PERF_MODEL_FILE, "r");
+  if(fp == NULL){
+    return;
+  }
+  struct perf_sample s;
+  while(fscanf(fp, "%7s %c %d %d %lf %lf", s.component, &s.type, &s.unit, &s.processes, &s.nodes, &s.seconds) == 6){
+    if(s.processes > 0 && s.seconds >= 0.0){
+      samples.push_back(s);
+    }
+  }
+  fclose(fp);
+}
+
+//only data movement is fitted against the whole interface, everything else against each rank's share
+inline double perf_model_x(const char *component, double nodes, int processes){
+  return (strcmp(component, "comm") == 0) ? nodes : nodes / processes;
+}
+
+/*
+ * Least squares fit of every sample of the component and unit type. A
+ * negative serial term is not physical, so the line is then forced through
+ * the origin, as it is when the samples cannot separate the two terms.
+ */
+inline bool perf_model_fit(const std::vector<struct perf_sample> &samples, const char *component, char type, struct perf_fit *fit){
+  double sx = 0.0, st = 0.0, sxx = 0.0, sxt = 0.0;
+  int n = 0;
+  for(int i = 0; i < (int) samples.size(); i++){
+    const struct perf_sample &s = samples[i];
+    if(strcmp(s.component, component) == 0 && s.type == type){
+      double x = perf_model_x(component, s.nodes, s.processes);
+      sx += x;
+      st += s.seconds;
+      sxx += x * x;
+      sxt += x * s.seconds;
+      n++;
+    }
+  }
+  fit->samples = n;
+  if(n == 0){
+    return false;
+  }
+  double var = sxx - sx * sx / n;
+  fit->serial = 0.0;
+  fit->parallel = 0.0;
+  if(n > 1 && var > 1e-12 * sxx){
+    fit->parallel = (sxt - sx * st / n) / var;
+    fit->serial = (st - fit->parallel * sx) / n;
+  }
+  if(fit->serial < 0.0 || fit->parallel < 0.0 || n == 1 || var <= 1e-12 * sxx){
+    fit->serial = 0.0;
+    fit->parallel = (sxx > 0.0) ? sxt / sxx : 0.0;
+    if(sxx <= 0.0){
+      fit->serial = st / n;
+    }
+  }
+  return true;
+}
+
+inline double perf_fit_eval(const struct perf_fit *fit, double x){
+  return fit->serial + fit->parallel * x;
+}
+
+//interface of a unit as calibrated, falling back to the mean over units of its type
+inline double perf_model_nodes(const std::vector<struct perf_sample> &samples, const char *component, char type, int unit){
+  double own = 0.0, any = 0.0;
+  int own_n = 0, any_n = 0;
+  for(int i = 0; i < (int) samples.size(); i++){
+    const struct perf_sample &s = samples[i];
+    if(strcmp(s.component, component) == 0 && s.type == type){
+      any += s.nodes;
+      any_n++;
+      if(s.unit == unit){
+        own += s.nodes;
+        own_n++;
+      }
+    }
+  }
+  return (own_n > 0) ? own / own_n : ((any_n > 0) ? any / any_n : -1.0);
+}
+
+/*
+ * What a unit's time per coupling cycle is made of, fitted once so it can be
+ * evaluated at any number of ranks: the solver of a work unit, or the search,
+ * interpolation and data movement of a coupler.
+ */
+struct perf_curve{
+  int parts;//1 for a work unit, 3 for a coupler
+  const char *component[3];
+  struct perf_fit fit[3];
+  double nodes[3];
+  double search_every;//coupling cycles per search of a coupler
+};
+
+//fits the curve of unit u, false if it was never calibrated
+inline bool perf_model_curve(const std::vector<struct perf_sample> &samples, const struct unit &unit, int u, int cycles, int search_freq, struct perf_curve *c){
+  static const char *work_components[1] = {"unit"};
+  static const char *coupler_components[3] = {"search", "interp", "comm"};
+  bool coupler = (unit.type == 'C');
+  char type = coupler ? unit.coupling_type : unit.type;
+  c->parts = coupler ? 3 : 1;
+  //sliding planes search every search_freq cycles, the other couplers only once
+  c->search_every = (type == 'S') ? search_freq : cycles;
+  for(int i = 0; i < c->parts; i++){
+    c->component[i] = coupler ? coupler_components[i] : work_components[i];
+    c->nodes[i] = perf_model_nodes(samples, c->component[i], type, u);
+    if(c->nodes[i] < 0.0 || !perf_model_fit(samples, c->component[i], type, &c->fit[i])){
+      return false;
+    }
+  }
+  return true;
+}
+
+//seconds the unit of the curve spends on a coupling cycle when run on processes ranks
+inline double perf_curve_eval(const struct perf_curve *c, int processes){
+  double part[3];
+  for(int i = 0; i < c->parts; i++){
+    part[i] = perf_fit_eval(&c->fit[i], perf_model_x(c->component[i], c->nodes[i], processes));
+  }
+  return (c->parts == 1) ? part[0] : part[0] / c->search_every + part[1] + part[2];
+}
+
+//seconds unit u spends on a coupling cycle when run on processes ranks, negative if it was never calibrated
+inline double perf_model_unit_seconds(const std::vector<struct perf_sample> &samples, const struct unit &unit, int u, int processes, int cycles, int search_freq){
+  struct perf_curve c;
+  if(!perf_model_curve(samples, unit, u, cycles, search_freq, &c)){
+    return -1.0;
+  }
+  return perf_curve_eval(&c, processes);
+}
+
+//a coupler's share of the cycle once both its units have arrived
+inline double perf_model_coupled(double left, double right, double coupler, bool overlapped){
+  double slowest = std::max(left, right);
+  return overlapped ? std::max(slowest, coupler) : slowest + coupler;
+}
+
+//seconds per coupling cycle, given each unit's time per cycle
+inline double perf_model_cycle(const std::vector<struct unit> &units, const std::vector<double> &seconds, bool overlapped){
+  double cycle = 0.0;
+  for(int u = 0; u < (int) units.size(); u++){
+    if(units[u].type == 'C'){
+      double left = seconds[units[u].mgcfd_units[0] - 1];
+      double right = seconds[units[u].mgcfd_units[1] - 1];
+      cycle = std::max(cycle, perf_model_coupled(left, right, seconds[u], overlapped));
+    }else{
+      cycle = std::max(cycle, seconds[u]);
+    }
+  }
+  return cycle;
+}
+
+/*
+ * Predicts a run of the given units over cycles coupling cycles. Sliding
+ * plane couplers search every search_freq cycles, overlapped says whether
+ * units may run ahead of the coupler's replies.
+ */
+inline void perf_model_predict(const std::vector<struct perf_sample> &samples, const std::vector<struct unit> &units, int cycles, int search_freq, bool overlapped, struct perf_prediction *p){
+  int n = units.size();
+  p->seconds.assign(n, 0.0);
+  p->missing = -1;
+  for(int u = 0; u < n && p->missing < 0; u++){
+    p->seconds[u] = perf_model_unit_seconds(samples, units[u], u, units[u].processes, cycles, search_freq);
+    if(p->seconds[u] < 0.0){
+      p->missing = u;
+    }
+  }
+  p->cycle = (p->missing < 0) ? perf_model_cycle(units, p->seconds, overlapped) : 0.0;
+  p->total = p->cycle * cycles;
+}
+
+/*
+ * Shares budget ranks out between the units for the shortest predicted
+ * cycle, every unit keeping at least one. The spare ranks are first handed
+ * out one at a time to whichever work unit is slowest, which is optimal as
+ * long as more ranks never slow a unit down. The split then sweeps ranks over
+ * to the couplers one at a time, the work unit that got a rank last giving it
+ * up to whichever coupler holds up the cycle the most, and the best split of
+ * the sweep is kept. Handing single ranks to whichever unit shortens the
+ * cycle most does not do, as two balanced units have to grow together before
+ * the cycle gets any shorter. Each unit is fitted once and the sweep only
+ * re-evaluates the two units a step changes, so it takes O(spare * units).
+ * False if a unit was never calibrated or there is no work unit.
+ */
+inline bool perf_model_split(const std::vector<struct perf_sample> &samples, std::vector<struct unit> &units, int budget, int cycles, int search_freq, bool overlapped, struct perf_prediction *p){
+  int n = units.size();
+  std::vector<int> work, couplers;
+  for(int u = 0; u < n; u++){
+    units[u].processes = 1;
+    if(units[u].type == 'C'){
+      couplers.push_back(u);
+    }else{
+      work.push_back(u);
+    }
+  }
+  if(work.empty()){
+    p->missing = -1;
+    return false;
+  }
+  perf_model_predict(samples, units, cycles, search_freq, overlapped, p);
+  if(p->missing >= 0 || budget < n){
+    return false;
+  }
+  std::vector<struct perf_curve> curves(n);
+  for(int u = 0; u < n; u++){
+    perf_model_curve(samples, units[u], u, cycles, search_freq, &curves[u]);
+  }
+  //seconds[u] is unit u's time per cycle on 1 + extra[u] ranks
+  int spare = budget - n;
+  std::vector<int> extra(n, 0);
+  std::vector<double> seconds = p->seconds;
+  //order in which the spare ranks go to the work units, the first w of them being the best use of w
+  std::vector<int> work_order(spare);
+  for(int k = 0; k < spare; k++){
+    int slowest = work[0];
+    for(int i = 1; i < (int) work.size(); i++){
+      if(seconds[work[i]] > seconds[slowest]){
+        slowest = work[i];
+      }
+    }
+    work_order[k] = slowest;
+    extra[slowest]++;
+    seconds[slowest] = perf_curve_eval(&curves[slowest], 1 + extra[slowest]);
+  }
+  std::vector<int> best_extra = extra;
+  double best_cycle = perf_model_cycle(units, seconds, overlapped);
+  for(int to_couplers = 1; to_couplers <= spare && !couplers.empty(); to_couplers++){
+    int giver = work_order[spare - to_couplers];
+    extra[giver]--;
+    seconds[giver] = perf_curve_eval(&curves[giver], 1 + extra[giver]);
+    int worst = -1;
+    double worst_seconds = -1.0;
+    for(int i = 0; i < (int) couplers.size(); i++){
+      int c = couplers[i];
+      double coupled = perf_model_coupled(seconds[units[c].mgcfd_units[0] - 1], seconds[units[c].mgcfd_units[1] - 1], seconds[c], overlapped);
+      if(coupled > worst_seconds){
+        worst = c;
+        worst_seconds = coupled;
+      }
+    }
+    extra[worst]++;
+    seconds[worst] = perf_curve_eval(&curves[worst], 1 + extra[worst]);
+    double cycle = perf_model_cycle(units, seconds, overlapped);
+    if(cycle < best_cycle){
+      best_cycle = cycle;
+      best_extra = extra;
+    }
+  }
+  for(int u = 0; u < n; u++){
+    units[u].processes = 1 + best_extra[u];
+  }
+  perf_model_predict(samples, units, cycles, search_freq, overlapped, p);
+  return true;
+}
+
+//number of different rank counts a component of the unit type was calibrated at
+inline int perf_model_rank_counts(const std::vector<struct perf_sample> &samples, const char *component, char type){
+  std::vector<int> counts;
+  for(int i = 0; i < (int) samples.size(); i++){
+    const struct perf_sample &s = samples[i];
+    if(strcmp(s.component, component) == 0 && s.type == type && std::find(counts.begin(), counts.end(), s.processes) == counts.end()){
+      counts.push_back(s.processes);
+    }
+  }
+  return counts.size();
+}
+
+inline void perf_model_print(const std::vector<struct unit> &units, const struct perf_prediction *p){
+  for(int u = 0; u < (int) units.size(); u++){
+    if(units[u].type == 'C'){
+      printf("  unit %d coupler type %c on %d ranks: %f s per coupling cycle\n", u + 1, units[u].coupling_type, units[u].processes, p->seconds[u]);
+    }else{
+      printf("  unit %d type %c on %d ranks: %f s per coupling cycle\n", u + 1, units[u].type, units[u].processes, p->seconds[u]);
+    }
+  }
+  printf("  predicted %f s per coupling cycle, %f s in total\n", p->cycle, p->total);
+}
+
+//prints the predicted runtime of target and of the best split of its ranks
+inline void perf_model_report(const std::vector<struct unit> &target, int cycles, int search_freq, bool overlapped){
+  std::vector<struct perf_sample> samples;
+  perf_model_load(samples);
+  struct perf_prediction p;
+  perf_model_predict(samples, target, cycles, search_freq, overlapped, &p);
+  if(p.missing >= 0){
+    fprintf(stderr, "Error: %s has no calibration data for unit %d, run it with record_calibration on first\n", PERF_MODEL_FILE, p.missing + 1);
+    return;
+  }
+  int budget = 0;
+  for(int u = 0; u < (int) target.size(); u++){
+    budget += target[u].processes;
+  }
+  printf("Model of the given configuration (%zu calibration samples):\n", samples.size());
+  perf_model_print(target, &p);
+  std::vector<struct unit> split = target;
+  if(perf_model_split(samples, split, budget, cycles, search_freq, overlapped, &p)){
+    printf("Best split of the same %d ranks:\n", budget);
+    perf_model_print(split, &p);
+  }
+}
+
+/*
+ * Splits budget ranks between the units for the shortest predicted coupling
+ * cycle, leaving the result in units. A unit calibrated at a single rank
+ * count can only be scaled by assuming it is perfectly parallel, which is
+ * warned about since it tends to overallocate that unit.
+ */
+inline bool perf_model_allocate(std::vector<struct unit> &units, int budget, int cycles, int search_freq, bool overlapped){
+  std::vector<struct perf_sample> samples;
+  perf_model_load(samples);
+  if(budget < (int) units.size()){
+    fprintf(stderr, "Error: %d ranks can not be shared between %zu units\n", budget, units.size());
+    return false;
+  }
+  struct perf_prediction p;
+  if(!perf_model_split(samples, units, budget, cycles, search_freq, overlapped, &p)){
+    if(p.missing >= 0){
+      fprintf(stderr, "Error: %s has no calibration data for unit %d, run it with record_calibration on first\n", PERF_MODEL_FILE, p.missing + 1);
+    }else{
+      fprintf(stderr, "Error: there are no work units to share ranks between\n");
+    }
+    return false;
+  }
+  for(int u = 0; u < (int) units.size(); u++){
+    bool coupler = (units[u].type == 'C');
+    char type = coupler ? units[u].coupling_type : units[u].type;
+    if(perf_model_rank_counts(samples, coupler ? "interp" : "unit", type) < 2){
+      fprintf(stderr, "Warning: units like unit %d were only calibrated at one rank count, their scaling is extrapolated\n", u + 1);
+    }
+  }
+  printf("Allocation of %d ranks:\n", budget);
+  perf_model_print(units, &p);
+  return true;
+}
+#endif
@@ -0,0 +1,87 @@
+#include <mpi.h>
+#include <vector>
+#include <algorithm>
+#include "structures.h"
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+/*
+ * Topology-aware rank layout. Units always hold consecutive positions of the
+ * rank layout in the order they are listed in cpx_input.cfg, normally the
+ * position is the world rank. With placement on, the world ranks are sorted
+ * by node and handed out so each coupler unit's ranks come straight after the
+ * interface-owning ranks of its first unit and straight before those of its
+ * second, which keeps most coupling traffic inside a node. Every rank works
+ * out the same layout from the node of every world rank.
+ */
+
+//node of every world rank, identified by the lowest world rank on that node
+inline void placement_nodes(std::vector<int> &node_of){
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+  int node_leader = rank;
+  MPI_Bcast(&node_leader, 1, MPI_INT, 0, node_comm);
+  MPI_Comm_free(&node_comm);
+  node_of.resize(size);
+  MPI_Allgather(&node_leader, 1, MPI_INT, node_of.data(), 1, MPI_INT, MPI_COMM_WORLD);
+}
+
+/*
+ * Gives the next count ranks of unit u that have no world rank yet the next
+ * count node ordered slots. next holds how many ranks of each unit are placed.
+ */
+inline void placement_take(const std::vector<struct unit> &units, int u, int count, const std::vector<int> &slots, int *slot, std::vector<int> &next, std::vector<int> &layout){
+  count = std::min(count, units[u].processes - next[u]);
+  for(int i = 0; i < count; i++){
+    layout[units[u].first_rank + next[u]] = slots[*slot];
+    next[u]++;
+    (*slot)++;
+  }
+}
+
+/*
+ * Fills layout with the world rank at every position. Only the unit roots own
+ * interface data unless all_owners is set (every rank exchanges its own piece
+ * with the coupler), in which case whole units are placed around the coupler.
+ * first_rank of every unit must already hold its first position.
+ */
+inline void placement_layout(const std::vector<struct unit> &units, bool all_owners, std::vector<int> &layout){
+  std::vector<int> node_of;
+  placement_nodes(node_of);
+  int size = node_of.size();
+  std::vector<int> slots(size);
+  for(int r = 0; r < size; r++){
+    slots[r] = r;
+  }
+  std::stable_sort(slots.begin(), slots.end(), [&node_of](int l, int r){ return node_of[l] < node_of[r]; });
+
+  layout.assign(size, -1);
+  std::vector<int> next(units.size(), 0);
+  int slot = 0;
+  for(int c = 0; c < (int) units.size(); c++){
+    if(units[c].type == 'C'){
+      int left = units[c].mgcfd_units[0] - 1;
+      int right = units[c].mgcfd_units[1] - 1;
+      placement_take(units, left, all_owners ? units[left].processes : 1, slots, &slot, next, layout);
+      placement_take(units, c, units[c].processes, slots, &slot, next, layout);
+      placement_take(units, right, all_owners ? units[right].processes : 1, slots, &slot, next, layout);
+    }
+  }
+  for(int u = 0; u < (int) units.size(); u++){
+    placement_take(units, u, units[u].processes, slots, &slot, next, layout);
+  }
+}
+
+//world rank at a position, layout is empty when positions are world ranks
+inline int placement_rank(const std::vector<int> &layout, int position){
+  return layout.empty() ? position : layout[position];
+}
+
+inline int placement_position(const std::vector<int> &layout, int rank){
+  return layout.empty() ? rank : std::find(layout.begin(), layout.end(), rank) - layout.begin();
+}
+#endif
@@ -0,0 +1,569 @@
+#include <mpi.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "codec.h"
+
+#ifndef REDISTRIBUTION_H
+#define REDISTRIBUTION_H
+
+/*
+ * M x N redistribution of interface state between the ranks of a unit and the
+ * ranks of a coupler unit, so neither side funnels the interface through its
+ * root. The coupler lays the two interfaces end to end (left unit first) and
+ * splits that stream into its left and right arrays, each of which is cut into
+ * one contiguous chunk per coupler rank as redistribution_partition does. Every
+ * unit rank holds a contiguous block of its own interface, so each overlap
+ * between a unit block and a coupler chunk is a single message between the two
+ * ranks. Both ends compute the same schedule once at setup from the two
+ * interface sizes. With redistribution off the roots use the same machinery
+ * with one whole-interface piece per peer. The buffers never move, so each
+ * schedule is bound to persistent requests once and every coupling cycle just
+ * starts and completes them. A whole-interface piece whose two roots share a
+ * node can instead live in an MPI-3 shared memory window (redistribution_share),
+ * the unit writing its interface in place and the coupler reading it there.
+ * Or it can go through an RMA window the unit root exposes
+ * (redistribution_expose), which the coupler reads and writes on its own
+ * schedule so the unit never waits for the coupler to reach a receive.
+ * Pieces that do move by messages can be packed with a codec on the way
+ * (redistribution_compress). Their size then changes from one cycle to the
+ * next, so they are sent without persistent requests and received into a
+ * buffer big enough for any packing of the piece.
+ */
+#define REDISTRIBUTION_TAG 1 //pieces of the coupler's left array use this tag, pieces of its right array the next one
+
+//roles in a piece's RMA window: the unit root owns the memory, the coupler root gets and puts into it
+#define REDISTRIBUTION_RMA_OWNER 1
+#define REDISTRIBUTION_RMA_ORIGIN 2
+
+//completion counters at the start of an RMA window, each counts interfaces since setup
+#define REDISTRIBUTION_POSTED 0 //written into the window by the unit
+#define REDISTRIBUTION_TAKEN 1 //got by the coupler, the unit may write the next one
+#define REDISTRIBUTION_DONE 2 //replies put by the coupler
+#define REDISTRIBUTION_READ 3 //replies copied out by the unit, the coupler may put the next one
+#define REDISTRIBUTION_RMA_HEADER 64 //bytes before the first region, the counters padded to a cache line
+
+struct redistribution_piece{
+  int peer;//world rank at the other end
+  int array;//0 for the coupler's left array, 1 for its right array
+  int local_begin;//first node of the piece in this rank's buffer
+  int count;//number of nodes in the piece
+  int tag;//message tag, derived from array unless the piece is a whole interface
+  double *send_buf;//bound by redistribution_bind
+  double *recv_buf;
+  double *shared_send;//where this rank's sends land in the shared window, NULL if the piece moves by messages
+  double *shared_recv;//where the peer's sends land in the shared window
+  int rma;//REDISTRIBUTION_RMA_OWNER or _ORIGIN if the piece goes through an RMA window, 0 if not
+  long long rma_region;//doubles in each region of the RMA window, the unit's interface first then the reply
+  double *rma_local;//first region of the window on the owner
+  long long rma_sent;//interfaces this rank has handed over through the window
+  long long rma_received;
+  int codec;//CODEC_* the piece is packed with, CODEC_RAW sends its doubles as they are
+  double codec_error;//largest error CODEC_QUANTISE may introduce
+  std::vector<unsigned char> packed_send;//codec_bound bytes each if the piece is packed
+  std::vector<unsigned char> packed_recv;
+  std::vector<unsigned char> unpack_scratch;//codec_decode's scratch, kept so unpacking does not allocate every cycle
+};
+
+struct redistribution{
+  int vars;//state variables per node
+  int local_size;//interface nodes held by this rank
+  std::vector<struct redistribution_piece> pieces;
+  std::vector<MPI_Request> send_requests;
+  std::vector<MPI_Request> recv_requests;
+  std::vector<MPI_Win> windows;//shared or RMA window of each piece, MPI_WIN_NULL if it has none
+  std::vector<MPI_Request> packed_requests;//sends of packed pieces, MPI_REQUEST_NULL for the others
+  double raw_bytes;//interface bytes this rank packed or unpacked since setup
+  double packed_bytes;//what they took on the wire
+  double codec_seconds;//time spent packing and unpacking
+  double codec_max_error;//largest change packing made to a value this rank sent
+};
+
+//first node of block p when n nodes are split into parts contiguous blocks
+inline long long redistribution_block(long long n, int parts, int p){
+  return (n * p) / parts;
+}
+
+//splits n nodes into one contiguous chunk per rank, chunk sizes differ by at most one node
+inline void redistribution_partition(long long n, int parts, std::vector<int> &counts, std::vector<int> &displs){
+  counts.resize(parts);
+  displs.resize(parts);
+  for(int p = 0; p < parts; p++){
+    displs[p] = redistribution_block(n, parts, p);
+    counts[p] = redistribution_block(n, parts, p + 1) - displs[p];
+  }
+}
+
+/*
+ * Resizes the chunks so each rank's share is proportional to how fast it got
+ * through its current chunk, given the cost (time) each rank measured for it.
+ * No rank is given more than max_count nodes, which must leave room for all
+ * n. The partition is left alone unless the slowest rank is more than
+ * rebalance_tolerance slower than the average. Returns true if it changed.
+ */
+inline bool redistribution_rebalance(long long n, const std::vector<double> &costs, std::vector<int> &counts, std::vector<int> &displs, double rebalance_tolerance, int max_count){
+  int parts = counts.size();
+  double max_cost = 0.0;
+  double total_cost = 0.0;
+  for(int p = 0; p < parts; p++){
+    if(costs[p] <= 0.0){
+      return false;
+    }
+    max_cost = std::max(max_cost, costs[p]);
+    total_cost += costs[p];
+  }
+  if(max_cost <= (1.0 + rebalance_tolerance) * (total_cost / parts)){
+    return false;
+  }
+  std::vector<double> speed(parts);
+  for(int p = 0; p < parts; p++){
+    speed[p] = std::max(counts[p], 1) / costs[p];
+  }
+  //every rank keeps at least one node (if there are enough) and the rest are shared by speed, ranks that would pass max_count are held there
+  long long base = (n >= parts) ? 1 : 0;
+  std::vector<double> share(parts);
+  std::vector<char> capped(parts, 0);
+  bool capping = true;
+  while(capping){
+    capping = false;
+    long long free_nodes = n;
+    int free_ranks = 0;
+    double free_speed = 0.0;
+    for(int p = 0; p < parts; p++){
+      if(capped[p]){
+        free_nodes -= max_count;
+      }else{
+        free_ranks++;
+        free_speed += speed[p];
+      }
+    }
+    for(int p = 0; p < parts; p++){
+      share[p] = capped[p] ? max_count : base + (free_nodes - base * free_ranks) * speed[p] / free_speed;
+      if(!capped[p] && share[p] > max_count){
+        capped[p] = 1;
+        capping = true;
+      }
+    }
+  }
+  //round down, then hand the nodes left over to the largest fractions
+  long long floor_total = 0;
+  std::vector< std::pair<double, int> > fractions(parts);
+  std::vector<int> new_counts(parts);
+  for(int p = 0; p < parts; p++){
+    new_counts[p] = (int) share[p];
+    floor_total += new_counts[p];
+    fractions[p] = std::make_pair(share[p] - new_counts[p], p);
+  }
+  std::sort(fractions.begin(), fractions.end());
+  for(int p = parts - 1; floor_total < n; p--){
+    new_counts[fractions[p].second]++;
+    floor_total++;
+  }
+  if(new_counts == counts){
+    return false;
+  }
+  counts = new_counts;
+  for(int p = 0; p < parts; p++){
+    displs[p] = (p == 0) ? 0 : displs[p - 1] + counts[p - 1];
+  }
+  return true;
+}
+
+inline void redistribution_add(struct redistribution *r, int peer, int array, long long begin, long long end, long long chunk_begin, long long chunk_end, long long local_origin){
+  long long lo = std::max(begin, chunk_begin);
+  long long hi = std::min(end, chunk_end);
+  if(lo < hi){
+    struct redistribution_piece piece = {};
+    piece.peer = peer;
+    piece.array = array;
+    piece.local_begin = lo - local_origin;
+    piece.count = hi - lo;
+    piece.tag = REDISTRIBUTION_TAG + array;
+    piece.shared_send = NULL;
+    piece.shared_recv = NULL;
+    piece.rma = 0;
+    piece.codec = CODEC_RAW;
+    r->pieces.push_back(piece);
+  }
+}
+
+inline void redistribution_finish(struct redistribution *r){
+  r->send_requests.resize(r->pieces.size());
+  r->recv_requests.resize(r->pieces.size());
+  r->windows.assign(r->pieces.size(), MPI_WIN_NULL);
+  r->packed_requests.assign(r->pieces.size(), MPI_REQUEST_NULL);
+  r->raw_bytes = 0.0;
+  r->packed_bytes = 0.0;
+  r->codec_seconds = 0.0;
+  r->codec_max_error = 0.0;
+}
+
+/*
+ * Schedule for rank unit_rank of a unit with unit_ranks ranks. is_left says
+ * which side of the coupler the unit is on, coupler_ranks are the world ranks
+ * of the coupler unit.
+ */
+inline void redistribution_unit_schedule(struct redistribution *r, const std::vector<int> &coupler_ranks, long long left_size, long long right_size, bool is_left, int unit_rank, int unit_ranks, int vars){
+  long long array_size = (left_size + right_size) / 2;
+  long long side_size = is_left ? left_size : right_size;
+  long long offset = is_left ? 0 : left_size;
+  long long begin = offset + redistribution_block(side_size, unit_ranks, unit_rank);
+  long long end = offset + redistribution_block(side_size, unit_ranks, unit_rank + 1);
+  r->vars = vars;
+  r->local_size = end - begin;
+  r->pieces.clear();
+  for(int a = 0; a < 2; a++){
+    for(int c = 0; c < (int) coupler_ranks.size(); c++){
+      long long chunk_begin = a * array_size + redistribution_block(array_size, coupler_ranks.size(), c);
+      long long chunk_end = a * array_size + redistribution_block(array_size, coupler_ranks.size(), c + 1);
+      redistribution_add(r, coupler_ranks[c], a, begin, end, chunk_begin, chunk_end, begin);
+    }
+  }
+  redistribution_finish(r);
+}
+
+//schedule for coupler rank coupler_rank of coupler_ranks, left_ranks and right_ranks are the world ranks of the two units
+inline void redistribution_coupler_schedule(struct redistribution *r, const std::vector<int> &left_ranks, const std::vector<int> &right_ranks, long long left_size, long long right_size, int coupler_rank, int coupler_ranks, int vars){
+  long long array_size = (left_size + right_size) / 2;
+  r->vars = vars;
+  r->local_size = redistribution_block(array_size, coupler_ranks, coupler_rank + 1) - redistribution_block(array_size, coupler_ranks, coupler_rank);
+  r->pieces.clear();
+  for(int s = 0; s < 2; s++){
+    const std::vector<int> &ranks = (s == 0) ? left_ranks : right_ranks;
+    long long side_size = (s == 0) ? left_size : right_size;
+    long long offset = (s == 0) ? 0 : left_size;
+    for(int u = 0; u < (int) ranks.size(); u++){
+      long long begin = offset + redistribution_block(side_size, ranks.size(), u);
+      long long end = offset + redistribution_block(side_size, ranks.size(), u + 1);
+      for(int a = 0; a < 2; a++){
+        long long chunk_begin = a * array_size + redistribution_block(array_size, coupler_ranks, coupler_rank);
+        redistribution_add(r, ranks[u], a, begin, end, chunk_begin, chunk_begin + r->local_size, chunk_begin);
+      }
+    }
+  }
+  redistribution_finish(r);
+}
+
+/*
+ * Schedule for a root that exchanges whole interfaces with up to two peers
+ * (a negative peer is skipped), piece i of the result being the one with peer
+ * i. These are the messages of the original root to root coupling, so they
+ * keep its tag.
+ */
+inline void redistribution_root_schedule(struct redistribution *r, int left_peer, int left_size, int right_peer, int right_size, int vars){
+  r->vars = vars;
+  r->local_size = left_size;
+  r->pieces.clear();
+  int peers[2] = {left_peer, right_peer};
+  int sizes[2] = {left_size, right_size};
+  for(int a = 0; a < 2; a++){
+    if(peers[a] >= 0){
+      struct redistribution_piece piece = {};
+      piece.peer = peers[a];
+      piece.array = a;
+      piece.local_begin = 0;
+      piece.count = sizes[a];
+      piece.tag = 0;
+      piece.shared_send = NULL;
+      piece.shared_recv = NULL;
+      piece.rma = 0;
+      piece.codec = CODEC_RAW;
+      r->pieces.push_back(piece);
+    }
+  }
+  redistribution_finish(r);
+}
+
+//communicator of just the two roots of a whole-interface piece, the owner first
+inline MPI_Comm redistribution_pair(const struct redistribution_piece &piece, bool owner){
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  int pair[2] = {owner ? rank : piece.peer, owner ? piece.peer : rank};
+  MPI_Group world_group;
+  MPI_Group pair_group;
+  MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+  MPI_Group_incl(world_group, 2, pair, &pair_group);
+  MPI_Comm pair_comm;
+  MPI_Comm_create_group(MPI_COMM_WORLD, pair_group, REDISTRIBUTION_TAG, &pair_comm);
+  MPI_Group_free(&pair_group);
+  MPI_Group_free(&world_group);
+  return pair_comm;
+}
+
+/*
+ * Moves piece i of a root schedule into a shared memory window if its peer is
+ * on the same node, otherwise it stays on messages and false is returned.
+ * Both roots call this at setup, the unit root as owner. The owner's segment
+ * has two regions of capacity doubles: the one the unit sends from and the
+ * one the coupler's replies land in. Callers that point their buffers at the
+ * piece's shared_send and shared_recv skip both copies; anything else is
+ * copied in and out. Must come before redistribution_bind.
+ */
+inline bool redistribution_share(struct redistribution *r, int i, bool owner, size_t capacity){
+  struct redistribution_piece &piece = r->pieces[i];
+  MPI_Comm pair_comm = redistribution_pair(piece, owner);
+  //the owner keeps rank 0 of the node communicator, which is only the pair if both are on one node
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(pair_comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+  MPI_Comm_free(&pair_comm);
+  int node_size;
+  MPI_Comm_size(node_comm, &node_size);
+  if(node_size < 2){
+    MPI_Comm_free(&node_comm);
+    return false;
+  }
+  double *base;
+  MPI_Win_allocate_shared(owner ? 2 * capacity * sizeof(double) : 0, sizeof(double), MPI_INFO_NULL, node_comm, &base, &r->windows[i]);
+  MPI_Comm_free(&node_comm);
+  MPI_Aint bytes;
+  int disp_unit;
+  MPI_Win_shared_query(r->windows[i], 0, &bytes, &disp_unit, &base);
+  size_t region = bytes / sizeof(double) / 2;
+  piece.shared_send = owner ? base : base + region;
+  piece.shared_recv = owner ? base + region : base;
+  return true;
+}
+
+/*
+ * Moves piece i of a root schedule into an RMA window on the unit root, the
+ * owner, who puts capacity doubles in each of its two regions. Both roots
+ * call this at setup and hold a passive target epoch on the window until
+ * redistribution_free. The unit copies its interface into the window and
+ * bumps a counter without waiting for the coupler, which gets it whenever it
+ * is ready and puts the reply back the same way; the unit only waits once it
+ * needs that reply. Must come before redistribution_bind.
+ */
+inline void redistribution_expose(struct redistribution *r, int i, bool owner, size_t capacity){
+  struct redistribution_piece &piece = r->pieces[i];
+  MPI_Comm pair_comm = redistribution_pair(piece, owner);
+  long long region = capacity;
+  MPI_Bcast(&region, 1, MPI_LONG_LONG, 0, pair_comm);
+  char *base;
+  MPI_Win_allocate(owner ? REDISTRIBUTION_RMA_HEADER + 2 * region * sizeof(double) : 0, 1, MPI_INFO_NULL, pair_comm, &base, &r->windows[i]);
+  if(owner){
+    memset(base, 0, REDISTRIBUTION_RMA_HEADER);
+  }
+  //the counters must be zeroed before the coupler first reads them
+  MPI_Barrier(pair_comm);
+  MPI_Comm_free(&pair_comm);
+  MPI_Win_lock_all(0, r->windows[i]);
+  piece.rma = owner ? REDISTRIBUTION_RMA_OWNER : REDISTRIBUTION_RMA_ORIGIN;
+  piece.rma_region = region;
+  piece.rma_local = owner ? (double *) (base + REDISTRIBUTION_RMA_HEADER) : NULL;
+  piece.rma_sent = 0;
+  piece.rma_received = 0;
+}
+
+//atomically adds add to one of the counters of piece i's RMA window and returns its previous value, add 0 just reads it
+inline long long redistribution_counter(struct redistribution *r, int i, int counter, long long add){
+  long long value;
+  MPI_Fetch_and_op(&add, &value, MPI_LONG_LONG, 0, counter * sizeof(long long), add == 0 ? MPI_NO_OP : MPI_SUM, r->windows[i]);
+  MPI_Win_flush(0, r->windows[i]);
+  return value;
+}
+
+inline void redistribution_wait_counter(struct redistribution *r, int i, int counter, long long at_least){
+  while(redistribution_counter(r, i, counter, 0) < at_least){
+  }
+}
+
+//hands the interface of piece i over through its RMA window
+inline void redistribution_rma_send(struct redistribution *r, int i){
+  struct redistribution_piece &piece = r->pieces[i];
+  size_t count = (size_t) piece.count * r->vars;
+  if(piece.rma == REDISTRIBUTION_RMA_OWNER){
+    //the coupler must have got the previous interface before it is overwritten
+    redistribution_wait_counter(r, i, REDISTRIBUTION_TAKEN, piece.rma_sent);
+    memcpy(piece.rma_local, piece.send_buf, count * sizeof(double));
+    MPI_Win_sync(r->windows[i]);
+    redistribution_counter(r, i, REDISTRIBUTION_POSTED, 1);
+  }else{
+    //and the unit must have copied out the previous reply
+    redistribution_wait_counter(r, i, REDISTRIBUTION_READ, piece.rma_sent);
+    MPI_Put(piece.send_buf, count, MPI_DOUBLE, 0, REDISTRIBUTION_RMA_HEADER + piece.rma_region * sizeof(double), count, MPI_DOUBLE, r->windows[i]);
+    MPI_Win_flush(0, r->windows[i]);
+    redistribution_counter(r, i, REDISTRIBUTION_DONE, 1);
+  }
+  piece.rma_sent++;
+}
+
+inline void redistribution_rma_recv(struct redistribution *r, int i){
+  struct redistribution_piece &piece = r->pieces[i];
+  size_t count = (size_t) piece.count * r->vars;
+  if(piece.rma == REDISTRIBUTION_RMA_OWNER){
+    redistribution_wait_counter(r, i, REDISTRIBUTION_DONE, piece.rma_received + 1);
+    MPI_Win_sync(r->windows[i]);
+    memcpy(piece.recv_buf, piece.rma_local + piece.rma_region, count * sizeof(double));
+    redistribution_counter(r, i, REDISTRIBUTION_READ, 1);
+  }else{
+    redistribution_wait_counter(r, i, REDISTRIBUTION_POSTED, piece.rma_received + 1);
+    MPI_Get(piece.recv_buf, count, MPI_DOUBLE, 0, REDISTRIBUTION_RMA_HEADER, count, MPI_DOUBLE, r->windows[i]);
+    MPI_Win_flush(0, r->windows[i]);
+    redistribution_counter(r, i, REDISTRIBUTION_TAKEN, 1);
+  }
+  piece.rma_received++;
+}
+
+/*
+ * Creates a persistent send and receive for every piece. Pieces of the
+ * coupler's left array are sent from send_left and received into recv_left,
+ * the rest use send_right and recv_right. The buffers must stay put until
+ * redistribution_free. Shared and RMA pieces get requests to MPI_PROC_NULL, which
+ * complete at once, so callers can start and wait on every piece alike.
+ */
+inline void redistribution_bind(struct redistribution *r, double *send_left, double *send_right, double *recv_left, double *recv_right){
+  for(int i = 0; i < (int) r->pieces.size(); i++){
+    struct redistribution_piece &piece = r->pieces[i];
+    long long offset = (long long) piece.local_begin * r->vars;
+    piece.send_buf = ((piece.array == 0) ? send_left : send_right) + offset;
+    piece.recv_buf = ((piece.array == 0) ? recv_left : recv_right) + offset;
+    int peer = (piece.shared_send != NULL || piece.rma != 0) ? MPI_PROC_NULL : piece.peer;
+    if(piece.codec != CODEC_RAW){
+      MPI_Send_init(piece.send_buf, 0, MPI_DOUBLE, MPI_PROC_NULL, piece.tag, MPI_COMM_WORLD, &r->send_requests[i]);
+      MPI_Recv_init(piece.packed_recv.data(), piece.packed_recv.size(), MPI_BYTE, peer, piece.tag, MPI_COMM_WORLD, &r->recv_requests[i]);
+      continue;
+    }
+    MPI_Send_init(piece.send_buf, piece.count * r->vars, MPI_DOUBLE, peer, piece.tag, MPI_COMM_WORLD, &r->send_requests[i]);
+    MPI_Recv_init(piece.recv_buf, piece.count * r->vars, MPI_DOUBLE, peer, piece.tag, MPI_COMM_WORLD, &r->recv_requests[i]);
+  }
+}
+
+/*
+ * Packs every piece that moves by messages with codec, both ends of a piece
+ * choosing the same one. Call before redistribution_bind.
+ */
+inline void redistribution_compress(struct redistribution *r, int codec, double error_bound){
+  for(int i = 0; i < (int) r->pieces.size(); i++){
+    struct redistribution_piece &piece = r->pieces[i];
+    if(codec != CODEC_RAW && piece.shared_send == NULL && piece.rma == 0){
+      piece.codec = codec;
+      piece.codec_error = error_bound;
+      piece.packed_send.resize(codec_bound((size_t) piece.count * r->vars));
+      piece.packed_recv.resize(codec_bound((size_t) piece.count * r->vars));
+      piece.unpack_scratch.resize((size_t) piece.count * r->vars * sizeof(double));
+    }
+  }
+}
+
+
+inline void redistribution_free(struct redistribution *r){
+  for(int i = 0; i < (int) r->pieces.size(); i++){
+    MPI_Request_free(&r->send_requests[i]);
+    MPI_Request_free(&r->recv_requests[i]);
+    if(r->pieces[i].rma != 0){
+      MPI_Win_unlock_all(r->windows[i]);
+    }
+    if(r->windows[i] != MPI_WIN_NULL){
+      MPI_Win_free(&r->windows[i]);
+    }
+  }
+}
+
+/*
+ * The two roots of a shared piece take turns on its window, each fence
+ * handing it over. The unit fences once its interface is written and again
+ * to get the reply, the coupler the other way round.
+ */
+inline void redistribution_hand_over(struct redistribution *r, int i){
+  MPI_Win_fence(0, r->windows[i]);
+}
+
+//finishes the receive of piece i once its request has completed
+inline void redistribution_arrived(struct redistribution *r, int i){
+  struct redistribution_piece &piece = r->pieces[i];
+  if(piece.codec != CODEC_RAW){
+    double start = MPI_Wtime();
+    codec_decode(piece.packed_recv.data(), piece.recv_buf, (size_t) piece.count * r->vars, piece.unpack_scratch.data());
+    r->codec_seconds += MPI_Wtime() - start;
+    r->raw_bytes += (double) piece.count * r->vars * sizeof(double);
+    r->packed_bytes += codec_size(piece.packed_recv.data());
+  }else if(piece.shared_recv != NULL){
+    redistribution_hand_over(r, i);
+    if(piece.recv_buf != piece.shared_recv){
+      memcpy(piece.recv_buf, piece.shared_recv, (size_t) piece.count * r->vars * sizeof(double));
+    }
+  }else if(piece.rma != 0){
+    redistribution_rma_recv(r, i);
+  }
+}
+
+inline void redistribution_start_recv(struct redistribution *r){
+  if(!r->recv_requests.empty()){
+    MPI_Startall(r->recv_requests.size(), r->recv_requests.data());
+  }
+}
+
+inline void redistribution_start_send(struct redistribution *r){
+  for(int i = 0; i < (int) r->pieces.size(); i++){
+    struct redistribution_piece &piece = r->pieces[i];
+    if(piece.codec != CODEC_RAW){
+      double start = MPI_Wtime();
+      double error;
+      size_t bytes = codec_encode(piece.codec, piece.codec_error, piece.send_buf, (size_t) piece.count * r->vars, piece.packed_send.data(), &error);
+      r->codec_seconds += MPI_Wtime() - start;
+      r->codec_max_error = std::max(r->codec_max_error, error);
+      r->raw_bytes += (double) piece.count * r->vars * sizeof(double);
+      r->packed_bytes += bytes;
+      MPI_Isend(piece.packed_send.data(), bytes, MPI_BYTE, piece.peer, piece.tag, MPI_COMM_WORLD, &r->packed_requests[i]);
+    }else if(piece.shared_send != NULL && piece.send_buf != piece.shared_send){
+      memcpy(piece.shared_send, piece.send_buf, (size_t) piece.count * r->vars * sizeof(double));
+    }else if(piece.rma != 0){
+      redistribution_rma_send(r, i);
+    }
+  }
+  if(!r->send_requests.empty()){
+    MPI_Startall(r->send_requests.size(), r->send_requests.data());
+  }
+}
+
+inline void redistribution_wait_recv(struct redistribution *r){
+  MPI_Waitall(r->recv_requests.size(), r->recv_requests.data(), MPI_STATUSES_IGNORE);
+  for(int i = 0; i < (int) r->pieces.size(); i++){
+    redistribution_arrived(r, i);
+  }
+}
+
+/*
+ * True once every receive started by redistribution_start_recv has landed,
+ * which are then finished as redistribution_wait_recv would. A shared piece
+ * can only be waited for, so it never tests ready.
+ */
+inline bool redistribution_test_recv(struct redistribution *r){
+  int done;
+  MPI_Testall(r->recv_requests.size(), r->recv_requests.data(), &done, MPI_STATUSES_IGNORE);
+  for(int i = 0; done && i < (int) r->pieces.size(); i++){
+    const struct redistribution_piece &piece = r->pieces[i];
+    if(piece.shared_recv != NULL){
+      done = false;
+    }else if(piece.rma != 0){
+      done = redistribution_counter(r, i, (piece.rma == REDISTRIBUTION_RMA_OWNER) ? REDISTRIBUTION_DONE : REDISTRIBUTION_POSTED, 0) > piece.rma_received;
+    }
+  }
+  for(int i = 0; done && i < (int) r->pieces.size(); i++){
+    redistribution_arrived(r, i);
+  }
+  return done;
+}
+
+inline void redistribution_wait_send(struct redistribution *r){
+  MPI_Waitall(r->send_requests.size(), r->send_requests.data(), MPI_STATUSES_IGNORE);
+  MPI_Waitall(r->packed_requests.size(), r->packed_requests.data(), MPI_STATUSES_IGNORE);
+  for(int i = 0; i < (int) r->pieces.size(); i++){
+    if(r->pieces[i].shared_send != NULL){
+      redistribution_hand_over(r, i);
+    }
+  }
+}
+
+//blocking exchanges for the unit side
+inline void redistribution_send(struct redistribution *r){
+  redistribution_start_send(r);
+  redistribution_wait_send(r);
+}
+
+inline void redistribution_recv(struct redistribution *r){
+  redistribution_start_recv(r);
+  redistribution_wait_recv(r);
+}
+#endif
@@ -0,0 +1,142 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/*
+ * Timeline of what every rank does in each coupling cycle. Ranks record the
+ * phases below as complete events in memory, and at exit every unit gathers
+ * its ranks' events on its root, which formats them as Chrome trace events
+ * and sends them to world rank 0. That writes them all to TRACE_FILE, which
+ * chrome://tracing and ui.perfetto.dev open with one process per unit and
+ * one thread per rank. Timestamps come from the system clock, so ranks on
+ * different nodes line up as well as the nodes' clocks agree.
+ */
+#define TRACE_FILE "cpx_trace.json"
+#define TRACE_TAG 7117
+
+enum trace_phase{TRACE_SOLVE, TRACE_PACK, TRACE_SEND, TRACE_WAIT, TRACE_SEARCH, TRACE_INTERPOLATE, TRACE_UNPACK, TRACE_PHASES};
+
+static const char *trace_phase_names[TRACE_PHASES] = {"solve", "pack", "send", "wait", "search", "interpolate", "unpack"};
+
+struct trace{
+  bool enabled;
+  std::string name;//as the unit is shown, e.g. MG-CFD 1
+  int unit;//position in cpx_input.cfg
+  int rank;//within the unit
+  std::vector<double> events;//phase, begin, end and cycle of every event, flat so it can be gathered as is
+};
+
+//microseconds, the unit of Chrome trace timestamps
+inline double trace_now(){
+  return std::chrono::duration<double, std::micro>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+inline void trace_init(struct trace *t, bool enabled, const std::string &name, int unit, int rank){
+  t->enabled = enabled;
+  t->name = name;
+  t->unit = unit;
+  t->rank = rank;
+  t->events.clear();
+}
+
+//records a phase that started at begin, as returned by trace_now, and ends now
+inline void trace_record(struct trace *t, enum trace_phase phase, double begin, int cycle){
+  if(t->enabled){
+    double event[4] = {(double) phase, begin, trace_now(), (double) cycle};
+    t->events.insert(t->events.end(), event, event + 4);
+  }
+}
+
+inline void trace_format(std::string &json, const char *format, ...){
+  char line[256];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  json += line;
+}
+
+/*
+ * Collective over the unit's ranks in comm. World rank 0 collects every unit
+ * and so only returns once all of them have written theirs, which they do
+ * when they finish, a few moments apart in a coupled run.
+ */
+inline void trace_write(struct trace *t, MPI_Comm comm){
+  if(!t->enabled){
+    return;
+  }
+  int unit_rank, unit_size, world_rank, world_size;
+  MPI_Comm_rank(comm, &unit_rank);
+  MPI_Comm_size(comm, &unit_size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+  int count = t->events.size();
+  std::vector<int> counts(unit_size), displs(unit_size, 0);
+  MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+  for(int r = 1; r < unit_size; r++){
+    displs[r] = displs[r-1] + counts[r-1];
+  }
+  std::vector<double> all((unit_rank == 0) ? displs[unit_size-1] + counts[unit_size-1] : 0);
+  MPI_Gatherv(t->events.data(), count, MPI_DOUBLE, all.data(), counts.data(), displs.data(), MPI_DOUBLE, 0, comm);
+
+  std::string json;
+  if(unit_rank == 0){
+    int pid = t->unit + 1;
+    trace_format(json, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s\"}},\n", pid, t->name.c_str());
+    trace_format(json, "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"sort_index\":%d}}", pid, pid);
+    for(int r = 0; r < unit_size; r++){
+      trace_format(json, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"rank %d\"}}", pid, r, r);
+      for(int e = displs[r]; e < displs[r] + counts[r]; e += 4){
+        trace_format(json, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"cycle\":%d}}",
+          trace_phase_names[(int) all[e]], pid, r, all[e+1], all[e+2] - all[e+1], (int) all[e+3]);
+      }
+    }
+  }
+
+  //every unit root tells rank 0 how many ranks its part covers, then sends it
+  if(unit_rank == 0 && world_rank != 0){
+    MPI_Send(&unit_size, 1, MPI_INT, 0, TRACE_TAG, MPI_COMM_WORLD);
+    MPI_Send(json.c_str(), json.size(), MPI_CHAR, 0, TRACE_TAG + 1, MPI_COMM_WORLD);
+  }
+  if(world_rank == 0){
+    FILE *fp = fopen(TRACE_FILE, "w");
+    if(fp == NULL){
+      fprintf(stderr, "Warning: could not write %s\n", TRACE_FILE);
+    }
+    int covered = 0;
+    if(fp != NULL){
+      fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    }
+    if(unit_rank == 0){
+      covered += unit_size;
+      if(fp != NULL){
+        fprintf(fp, "%s", json.c_str());
+      }
+    }
+    while(covered < world_size){
+      MPI_Status status;
+      int ranks, length;
+      MPI_Recv(&ranks, 1, MPI_INT, MPI_ANY_SOURCE, TRACE_TAG, MPI_COMM_WORLD, &status);
+      MPI_Probe(status.MPI_SOURCE, TRACE_TAG + 1, MPI_COMM_WORLD, &status);
+      MPI_Get_count(&status, MPI_CHAR, &length);
+      std::string part(length, '\0');
+      MPI_Recv(&part[0], length, MPI_CHAR, status.MPI_SOURCE, TRACE_TAG + 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      if(fp != NULL){
+        fprintf(fp, "%s%s", (covered > 0) ? ",\n" : "", part.c_str());
+      }
+      covered += ranks;
+    }
+    if(fp != NULL){
+      fprintf(fp, "\n]}\n");
+      fclose(fp);
+    }
+  }
+}
+#endif